@@ -98,7 +98,7 @@ static HRESULT WINAPI DECLSPEC_HOTPATCH d3d8_swapchain_Present(IDirect3DSwapChai
         FIXME("Ignoring dirty_region %p.\n", dirty_region);
 
     return wined3d_swapchain_present(swapchain->wined3d_swapchain,
-            src_rect, dst_rect, dst_window_override, swapchain->swap_interval, 0);
+            src_rect, dst_rect, dst_window_override, NULL, 0, swapchain->swap_interval, 0);
 }
 
 static HRESULT WINAPI d3d8_swapchain_GetBackBuffer(IDirect3DSwapChain8 *iface,
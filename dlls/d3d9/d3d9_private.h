@@ -169,6 +169,8 @@ struct d3d9_swapchain
 
 HRESULT d3d9_swapchain_create(struct d3d9_device *device, struct wined3d_swapchain_desc *desc,
         unsigned int swap_interval, struct d3d9_swapchain **swapchain) DECLSPEC_HIDDEN;
+unsigned int d3d9_swapchain_get_dirty_rects(const struct d3d9_swapchain *swapchain,
+        const RGNDATA *dirty_region, const RECT **dirty_rects) DECLSPEC_HIDDEN;
 
 struct d3d9_surface
 {
@@ -1181,7 +1181,8 @@ static HRESULT WINAPI DECLSPEC_HOTPATCH d3d9_device_Present(IDirect3DDevice9Ex *
 {
     struct d3d9_device *device = impl_from_IDirect3DDevice9Ex(iface);
     struct d3d9_swapchain *swapchain;
-    unsigned int i;
+    unsigned int i, dirty_rect_count;
+    const RECT *dirty_rects;
     HRESULT hr;
 
     TRACE("iface %p, src_rect %s, dst_rect %s, dst_window_override %p, dirty_region %p.\n",
@@ -1190,15 +1191,13 @@ static HRESULT WINAPI DECLSPEC_HOTPATCH d3d9_device_Present(IDirect3DDevice9Ex *
     if (device->device_state != D3D9_DEVICE_STATE_OK)
         return device->d3d_parent->extended ? S_PRESENT_OCCLUDED : D3DERR_DEVICELOST;
 
-    if (dirty_region)
-        FIXME("Ignoring dirty_region %p.\n", dirty_region);
-
     wined3d_mutex_lock();
     for (i = 0; i < device->implicit_swapchain_count; ++i)
     {
         swapchain = wined3d_swapchain_get_parent(device->implicit_swapchains[i]);
-        if (FAILED(hr = wined3d_swapchain_present(swapchain->wined3d_swapchain,
-                src_rect, dst_rect, dst_window_override, swapchain->swap_interval, 0)))
+        dirty_rect_count = d3d9_swapchain_get_dirty_rects(swapchain, dirty_region, &dirty_rects);
+        if (FAILED(hr = wined3d_swapchain_present(swapchain->wined3d_swapchain, src_rect, dst_rect,
+                dst_window_override, dirty_rects, dirty_rect_count, swapchain->swap_interval, 0)))
         {
             wined3d_mutex_unlock();
             return hr;
@@ -4186,7 +4185,8 @@ static HRESULT WINAPI DECLSPEC_HOTPATCH d3d9_device_PresentEx(IDirect3DDevice9Ex
 {
     struct d3d9_device *device = impl_from_IDirect3DDevice9Ex(iface);
     struct d3d9_swapchain *swapchain;
-    unsigned int i;
+    unsigned int i, dirty_rect_count;
+    const RECT *dirty_rects;
     HRESULT hr;
 
     TRACE("iface %p, src_rect %s, dst_rect %s, dst_window_override %p, dirty_region %p, flags %#x.\n",
@@ -4196,15 +4196,13 @@ static HRESULT WINAPI DECLSPEC_HOTPATCH d3d9_device_PresentEx(IDirect3DDevice9Ex
     if (device->device_state != D3D9_DEVICE_STATE_OK)
         return S_PRESENT_OCCLUDED;
 
-    if (dirty_region)
-        FIXME("Ignoring dirty_region %p.\n", dirty_region);
-
     wined3d_mutex_lock();
     for (i = 0; i < device->implicit_swapchain_count; ++i)
     {
         swapchain = wined3d_swapchain_get_parent(device->implicit_swapchains[i]);
-        if (FAILED(hr = wined3d_swapchain_present(swapchain->wined3d_swapchain,
-                src_rect, dst_rect, dst_window_override, swapchain->swap_interval, flags)))
+        dirty_rect_count = d3d9_swapchain_get_dirty_rects(swapchain, dirty_region, &dirty_rects);
+        if (FAILED(hr = wined3d_swapchain_present(swapchain->wined3d_swapchain, src_rect, dst_rect,
+                dst_window_override, dirty_rects, dirty_rect_count, swapchain->swap_interval, flags)))
         {
             wined3d_mutex_unlock();
             return hr;
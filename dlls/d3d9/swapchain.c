@@ -133,12 +133,32 @@ static ULONG WINAPI d3d9_swapchain_Release(IDirect3DSwapChain9Ex *iface)
     return refcount;
 }
 
+/* The dirty region is only used with D3DSWAPEFFECT_COPY, and ignored otherwise. */
+unsigned int d3d9_swapchain_get_dirty_rects(const struct d3d9_swapchain *swapchain,
+        const RGNDATA *dirty_region, const RECT **dirty_rects)
+{
+    struct wined3d_swapchain_desc desc;
+
+    *dirty_rects = NULL;
+    if (!dirty_region || dirty_region->rdh.iType != RDH_RECTANGLES)
+        return 0;
+
+    wined3d_swapchain_get_desc(swapchain->wined3d_swapchain, &desc);
+    if (desc.swap_effect != WINED3D_SWAP_EFFECT_COPY)
+        return 0;
+
+    *dirty_rects = (const RECT *)dirty_region->Buffer;
+    return dirty_region->rdh.nCount;
+}
+
 static HRESULT WINAPI DECLSPEC_HOTPATCH d3d9_swapchain_Present(IDirect3DSwapChain9Ex *iface,
         const RECT *src_rect, const RECT *dst_rect, HWND dst_window_override,
         const RGNDATA *dirty_region, DWORD flags)
 {
     struct d3d9_swapchain *swapchain = impl_from_IDirect3DSwapChain9Ex(iface);
     struct d3d9_device *device = impl_from_IDirect3DDevice9Ex(swapchain->parent_device);
+    unsigned int dirty_rect_count;
+    const RECT *dirty_rects;
 
     TRACE("iface %p, src_rect %s, dst_rect %s, dst_window_override %p, dirty_region %p, flags %#x.\n",
             iface, wine_dbgstr_rect(src_rect), wine_dbgstr_rect(dst_rect),
@@ -147,11 +167,10 @@ static HRESULT WINAPI DECLSPEC_HOTPATCH d3d9_swapchain_Present(IDirect3DSwapChai
     if (device->device_state != D3D9_DEVICE_STATE_OK)
         return device->d3d_parent->extended ? S_PRESENT_OCCLUDED : D3DERR_DEVICELOST;
 
-    if (dirty_region)
-        FIXME("Ignoring dirty_region %p.\n", dirty_region);
+    dirty_rect_count = d3d9_swapchain_get_dirty_rects(swapchain, dirty_region, &dirty_rects);
 
-    return wined3d_swapchain_present(swapchain->wined3d_swapchain,
-            src_rect, dst_rect, dst_window_override, swapchain->swap_interval, flags);
+    return wined3d_swapchain_present(swapchain->wined3d_swapchain, src_rect, dst_rect,
+            dst_window_override, dirty_rects, dirty_rect_count, swapchain->swap_interval, flags);
 }
 
 static HRESULT WINAPI d3d9_swapchain_GetFrontBufferData(IDirect3DSwapChain9Ex *iface, IDirect3DSurface9 *surface)
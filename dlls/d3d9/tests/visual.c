@@ -17673,6 +17673,120 @@ done:
     DestroyWindow(window);
 }
 
+static void test_present_dirty_region(void)
+{
+    static const unsigned int counts[] = {1, 16, 100000};
+    static const RECT dirty = {64, 64, 128, 128};
+    static const struct
+    {
+        POINT point;
+        BOOL inside;
+    }
+    points[] =
+    {
+        {{ 64,  64}, TRUE},
+        {{ 96,  96}, TRUE},
+        {{127, 127}, TRUE},
+        {{ 63,  96}, FALSE},
+        {{128,  96}, FALSE},
+        {{ 96, 128}, FALSE},
+        {{320, 240}, FALSE},
+    };
+    IDirect3DSwapChain9 *swapchain;
+    D3DPRESENT_PARAMETERS d3dpp;
+    IDirect3DSurface9 *readback;
+    IDirect3DDevice9 *device;
+    unsigned int i, j, size;
+    RGNDATA *region;
+    IDirect3D9 *d3d;
+    ULONG refcount;
+    RECT *rects;
+    HWND window;
+    DWORD color;
+    HRESULT hr;
+
+    window = create_window();
+    d3d = Direct3DCreate9(D3D_SDK_VERSION);
+    ok(!!d3d, "Failed to create D3D object.\n");
+    if (!(device = create_device(d3d, window, window, FALSE)))
+    {
+        skip("Failed to create D3D device.\n");
+        goto done;
+    }
+
+    hr = IDirect3DDevice9_GetSwapChain(device, 0, &swapchain);
+    ok(hr == D3D_OK, "Failed to get the implicit swapchain, hr %#x.\n", hr);
+    hr = IDirect3DSwapChain9_GetPresentParameters(swapchain, &d3dpp);
+    ok(hr == D3D_OK, "Failed to get present parameters, hr %#x.\n", hr);
+    IDirect3DSwapChain9_Release(swapchain);
+    d3dpp.SwapEffect = D3DSWAPEFFECT_COPY;
+    hr = IDirect3DDevice9_Reset(device, &d3dpp);
+    ok(hr == D3D_OK, "Failed to reset device, hr %#x.\n", hr);
+
+    hr = IDirect3DDevice9_CreateOffscreenPlainSurface(device, 640, 480, D3DFMT_A8R8G8B8,
+            D3DPOOL_SYSTEMMEM, &readback, NULL);
+    ok(SUCCEEDED(hr), "Failed to create readback surface, hr %#x.\n", hr);
+
+    region = HeapAlloc(GetProcessHeap(), 0, sizeof(region->rdh) + counts[ARRAY_SIZE(counts) - 1] * sizeof(RECT));
+    ok(!!region, "Failed to allocate memory.\n");
+    rects = (RECT *)region->Buffer;
+
+    for (i = 0; i < ARRAY_SIZE(counts); ++i)
+    {
+        hr = IDirect3DDevice9_Clear(device, 0, NULL, D3DCLEAR_TARGET, 0x0000ff00, 0.0f, 0);
+        ok(SUCCEEDED(hr), "Test %u: Failed to clear render target, hr %#x.\n", i, hr);
+        hr = IDirect3DDevice9_Present(device, NULL, NULL, NULL, NULL);
+        ok(SUCCEEDED(hr), "Test %u: Failed to present, hr %#x.\n", i, hr);
+
+        /* Only the dirty rectangle is red in the back buffer, so red outside of
+         * it in the front buffer means the region was copied to the wrong place. */
+        hr = IDirect3DDevice9_Clear(device, 0, NULL, D3DCLEAR_TARGET, 0x000000ff, 0.0f, 0);
+        ok(SUCCEEDED(hr), "Test %u: Failed to clear render target, hr %#x.\n", i, hr);
+        hr = IDirect3DDevice9_Clear(device, 1, (const D3DRECT *)&dirty, D3DCLEAR_TARGET, 0x00ff0000, 0.0f, 0);
+        ok(SUCCEEDED(hr), "Test %u: Failed to clear render target, hr %#x.\n", i, hr);
+
+        /* Split the dirty rectangle into tiles, the largest count repeats them. */
+        size = counts[i] == 1 ? 64 : 16;
+        for (j = 0; j < counts[i]; ++j)
+        {
+            unsigned int tile = j % ((64 / size) * (64 / size));
+
+            SetRect(&rects[j], dirty.left + (tile % (64 / size)) * size, dirty.top + (tile / (64 / size)) * size,
+                    dirty.left + (tile % (64 / size) + 1) * size, dirty.top + (tile / (64 / size) + 1) * size);
+        }
+        region->rdh.dwSize = sizeof(region->rdh);
+        region->rdh.iType = RDH_RECTANGLES;
+        region->rdh.nCount = counts[i];
+        region->rdh.nRgnSize = counts[i] * sizeof(RECT);
+        region->rdh.rcBound = dirty;
+        hr = IDirect3DDevice9_Present(device, NULL, NULL, NULL, region);
+        ok(SUCCEEDED(hr), "Test %u: Failed to present, hr %#x.\n", i, hr);
+
+        hr = IDirect3DDevice9_GetFrontBufferData(device, 0, readback);
+        ok(hr == D3D_OK, "Test %u: Got unexpected hr %#x.\n", i, hr);
+        for (j = 0; j < ARRAY_SIZE(points); ++j)
+        {
+            color = getPixelColorFromSurface(readback, points[j].point.x, points[j].point.y) & 0x00ffffff;
+            if (points[j].inside)
+                ok(color_match(color, 0x00ff0000, 1), "Test %u: Got unexpected color 0x%08x at (%d, %d).\n",
+                        i, color, points[j].point.x, points[j].point.y);
+            else
+                /* Presenting more than the dirty region is allowed. */
+                ok(color_match(color, 0x0000ff00, 1) || color_match(color, 0x000000ff, 1),
+                        "Test %u: Got unexpected color 0x%08x at (%d, %d).\n",
+                        i, color, points[j].point.x, points[j].point.y);
+        }
+    }
+
+    HeapFree(GetProcessHeap(), 0, region);
+    IDirect3DSurface9_Release(readback);
+    refcount = IDirect3DDevice9_Release(device);
+    ok(!refcount, "Device has %u references left.\n", refcount);
+done:
+    IDirect3D9_Release(d3d);
+    DestroyWindow(window);
+}
+
 static void multisampled_depth_buffer_test(void)
 {
     IDirect3DDevice9 *device = 0;
@@ -27653,6 +27767,7 @@ START_TEST(visual)
     update_surface_test();
     multisample_get_rtdata_test();
     test_multisample_get_front_buffer_data();
+    test_present_dirty_region();
     zenable_test();
     fog_special_test();
     volume_srgb_test();
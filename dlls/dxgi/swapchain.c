@@ -314,9 +314,11 @@ static HRESULT STDMETHODCALLTYPE d3d11_swapchain_GetDevice(IDXGISwapChain1 *ifac
 
 /* IDXGISwapChain1 methods */
 
-static HRESULT d3d11_swapchain_present(struct d3d11_swapchain *swapchain,
-        unsigned int sync_interval, unsigned int flags)
+static HRESULT d3d11_swapchain_present(struct d3d11_swapchain *swapchain, unsigned int sync_interval,
+        unsigned int flags, const DXGI_PRESENT_PARAMETERS *present_parameters)
 {
+    const RECT *dirty_rects = NULL;
+    unsigned int dirty_rect_count = 0;
     HRESULT hr;
 
     if (sync_interval > 4)
@@ -336,7 +338,17 @@ static HRESULT d3d11_swapchain_present(struct d3d11_swapchain *swapchain,
         return S_OK;
     }
 
-    if (SUCCEEDED(hr = wined3d_swapchain_present(swapchain->wined3d_swapchain, NULL, NULL, NULL, sync_interval, 0)))
+    if (present_parameters)
+    {
+        if (present_parameters->pScrollRect || present_parameters->pScrollOffset)
+            FIXME("Ignoring scroll rect %s, offset %s.\n", wine_dbgstr_rect(present_parameters->pScrollRect),
+                    wine_dbgstr_point(present_parameters->pScrollOffset));
+        dirty_rects = present_parameters->pDirtyRects;
+        dirty_rect_count = present_parameters->DirtyRectsCount;
+    }
+
+    if (SUCCEEDED(hr = wined3d_swapchain_present(swapchain->wined3d_swapchain, NULL, NULL, NULL,
+            dirty_rects, dirty_rect_count, sync_interval, 0)))
         InterlockedIncrement(&swapchain->present_count);
     return hr;
 }
@@ -347,7 +359,7 @@ static HRESULT STDMETHODCALLTYPE DECLSPEC_HOTPATCH d3d11_swapchain_Present(IDXGI
 
     TRACE("iface %p, sync_interval %u, flags %#x.\n", iface, sync_interval, flags);
 
-    return d3d11_swapchain_present(swapchain, sync_interval, flags);
+    return d3d11_swapchain_present(swapchain, sync_interval, flags, NULL);
 }
 
 static HRESULT STDMETHODCALLTYPE d3d11_swapchain_GetBuffer(IDXGISwapChain1 *iface,
@@ -702,10 +714,7 @@ static HRESULT STDMETHODCALLTYPE d3d11_swapchain_Present1(IDXGISwapChain1 *iface
     TRACE("iface %p, sync_interval %u, flags %#x, present_parameters %p.\n",
             iface, sync_interval, flags, present_parameters);
 
-    if (present_parameters)
-        FIXME("Ignored present parameters %p.\n", present_parameters);
-
-    return d3d11_swapchain_present(swapchain, sync_interval, flags);
+    return d3d11_swapchain_present(swapchain, sync_interval, flags, present_parameters);
 }
 
 static BOOL STDMETHODCALLTYPE d3d11_swapchain_IsTemporaryMonoSupported(IDXGISwapChain1 *iface)
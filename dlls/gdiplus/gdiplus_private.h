@@ -270,6 +270,9 @@ struct GpGraphics{
     int temp_hbitmap_height;
     BYTE *temp_bits;
     HDC temp_hdc;
+    /* ARGB buffers for software rendering, kept across calls: */
+    void *scratch_bits[2];
+    SIZE_T scratch_size[2];
 };
 
 struct GpBrush{
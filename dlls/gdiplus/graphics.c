@@ -412,6 +412,66 @@ static GpStatus get_clip_hrgn(GpGraphics *graphics, HRGN *hrgn)
     return stat;
 }
 
+/* scratch buffers above this size are only kept until a smaller one is needed */
+#define MAX_SCRATCH_SIZE (1024 * 1024)
+
+/* Return one of the scratch buffers of the graphics object, growing it to at
+ * least size bytes. The contents are undefined. */
+static void *get_scratch_bits(GpGraphics *graphics, int index, SIZE_T size)
+{
+    void *bits;
+
+    if (graphics->scratch_size[index] < size ||
+        (graphics->scratch_size[index] > MAX_SCRATCH_SIZE && size <= MAX_SCRATCH_SIZE))
+    {
+        if (!(bits = heap_alloc(size)))
+            return NULL;
+        heap_free(graphics->scratch_bits[index]);
+        graphics->scratch_bits[index] = bits;
+        graphics->scratch_size[index] = size;
+    }
+
+    return graphics->scratch_bits[index];
+}
+
+/* Draw ARGB data directly to the bits of a 32bpp RGB or ARGB bitmap */
+static void alpha_blend_bmp_bits(GpBitmap *dst_bitmap, INT dst_x, INT dst_y, const BYTE *src,
+    INT src_width, INT src_height, INT src_stride, PixelFormat fmt, CompositingMode comp_mode)
+{
+    BOOL no_alpha = (dst_bitmap->format == PixelFormat32bppRGB);
+    INT left = max(dst_x, 0), top = max(dst_y, 0);
+    INT right = min(dst_x + src_width, dst_bitmap->width);
+    INT bottom = min(dst_y + src_height, dst_bitmap->height);
+    INT x, y;
+
+    for (y=top; y<bottom; y++)
+    {
+        const ARGB *src_row = (const ARGB*)(src + src_stride * (y - dst_y));
+        ARGB *dst_row = (ARGB*)(dst_bitmap->bits + dst_bitmap->stride * y);
+
+        for (x=left; x<right; x++)
+        {
+            ARGB dst_color, src_color = src_row[x - dst_x];
+
+            if (comp_mode == CompositingModeSourceCopy)
+                dst_color = (src_color & 0xff000000) ? src_color : 0;
+            else
+            {
+                if (!(src_color & 0xff000000))
+                    continue;
+
+                dst_color = no_alpha ? dst_row[x] | 0xff000000 : dst_row[x];
+                if (fmt & PixelFormatPAlpha)
+                    dst_color = color_over_fgpremult(dst_color, src_color);
+                else
+                    dst_color = color_over(dst_color, src_color);
+            }
+
+            dst_row[x] = no_alpha ? dst_color & 0xffffff : dst_color;
+        }
+    }
+}
+
 /* Draw ARGB data to the given graphics object */
 static GpStatus alpha_blend_bmp_pixels(GpGraphics *graphics, INT dst_x, INT dst_y,
     const BYTE *src, INT src_width, INT src_height, INT src_stride, const PixelFormat fmt)
@@ -422,6 +482,14 @@ static GpStatus alpha_blend_bmp_pixels(GpGraphics *graphics, INT dst_x, INT dst_
 
     GdipGetCompositingMode(graphics, &comp_mode);
 
+    if (dst_bitmap->bits && (dst_bitmap->format == PixelFormat32bppARGB ||
+                             dst_bitmap->format == PixelFormat32bppRGB))
+    {
+        alpha_blend_bmp_bits(dst_bitmap, dst_x, dst_y, src, src_width, src_height,
+            src_stride, fmt, comp_mode);
+        return Ok;
+    }
+
     for (y=0; y<src_height; y++)
     {
         for (x=0; x<src_width; x++)
@@ -2580,6 +2648,9 @@ GpStatus WINGDIPAPI GdipDeleteGraphics(GpGraphics *graphics)
 
     DeleteObject(graphics->gdi_clip);
 
+    heap_free(graphics->scratch_bits[0]);
+    heap_free(graphics->scratch_bits[1]);
+
     /* Native returns ObjectBusy on the second free, instead of crashing as we'd
      * do otherwise, but we can't have that in the test suite because it means
      * accessing freed memory. */
@@ -3156,7 +3227,7 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
             int i, x, y, src_stride, dst_stride;
             GpMatrix dst_to_src;
             REAL m11, m12, m21, m22, mdx, mdy;
-            LPBYTE src_data, dst_data, dst_dyn_data=NULL;
+            LPBYTE src_data, dst_data;
             BitmapData lockeddata;
             InterpolationMode interpolation = graphics->interpolation;
             PixelOffsetMode offset_mode = graphics->pixeloffset;
@@ -3217,7 +3288,7 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
 
             TRACE("src_area: %d x %d\n", src_area.Width, src_area.Height);
 
-            src_data = heap_alloc_zero(sizeof(ARGB) * src_area.Width * src_area.Height);
+            src_data = get_scratch_bits(graphics, 0, sizeof(ARGB) * src_area.Width * src_area.Height);
             if (!src_data)
                 return OutOfMemory;
             src_stride = sizeof(ARGB) * src_area.Width;
@@ -3239,10 +3310,7 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
                 stat = GdipBitmapUnlockBits(bitmap, &lockeddata);
 
             if (stat != Ok)
-            {
-                heap_free(src_data);
                 return stat;
-            }
 
             apply_image_attributes(imageAttributes, src_data,
                 src_area.Width, src_area.Height,
@@ -3251,12 +3319,10 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
             if (do_resampling)
             {
                 /* Transform the bits as needed to the destination. */
-                dst_data = dst_dyn_data = heap_alloc_zero(sizeof(ARGB) * (dst_area.right - dst_area.left) * (dst_area.bottom - dst_area.top));
+                dst_data = get_scratch_bits(graphics, 1,
+                    sizeof(ARGB) * (dst_area.right - dst_area.left) * (dst_area.bottom - dst_area.top));
                 if (!dst_data)
-                {
-                    heap_free(src_data);
                     return OutOfMemory;
-                }
 
                 dst_stride = sizeof(ARGB) * (dst_area.right - dst_area.left);
 
@@ -3301,10 +3367,6 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
 
             gdi_transform_release(graphics);
 
-            heap_free(src_data);
-
-            heap_free(dst_dyn_data);
-
             return stat;
         }
         else
@@ -3711,9 +3773,11 @@ static GpStatus SOFTWARE_GdipDrawThinPath(GpGraphics *graphics, GpPen *pen, GpPa
         gp_output_area.Width = output_width;
         gp_output_area.Height = output_height;
 
-        output_bits = heap_alloc_zero(output_width * output_height * sizeof(DWORD));
+        output_bits = get_scratch_bits(graphics, 0, output_width * output_height * sizeof(DWORD));
         if (!output_bits)
             stat = OutOfMemory;
+        else
+            memset(output_bits, 0, output_width * output_height * sizeof(DWORD));
     }
 
     if (stat == Ok)
@@ -3721,10 +3785,12 @@ static GpStatus SOFTWARE_GdipDrawThinPath(GpGraphics *graphics, GpPen *pen, GpPa
         if (pen->brush->bt != BrushTypeSolidColor)
         {
             /* allocate and draw brush output */
-            brush_bits = heap_alloc_zero(output_width * output_height * sizeof(DWORD));
+            brush_bits = get_scratch_bits(graphics, 1, output_width * output_height * sizeof(DWORD));
 
             if (brush_bits)
             {
+                /* Path gradients leave the pixels outside the path untouched. */
+                memset(brush_bits, 0, output_width * output_height * sizeof(DWORD));
                 stat = brush_fill_pixels(graphics, pen->brush, brush_bits,
                     &gp_output_area, output_width);
             }
@@ -3928,9 +3994,7 @@ static GpStatus SOFTWARE_GdipDrawThinPath(GpGraphics *graphics, GpPen *pen, GpPa
             gdi_transform_release(graphics);
         }
 
-        heap_free(brush_bits);
         heap_free(dyn_dash_pattern);
-        heap_free(output_bits);
     }
 
     GdipDeletePath(flat_path);
@@ -4675,9 +4739,12 @@ static GpStatus SOFTWARE_GdipFillRegion(GpGraphics *graphics, GpBrush *brush,
         gp_bound_rect.Width = bound_rect.right - bound_rect.left;
         gp_bound_rect.Height = bound_rect.bottom - bound_rect.top;
 
-        pixel_data = heap_alloc_zero(sizeof(*pixel_data) * gp_bound_rect.Width * gp_bound_rect.Height);
+        pixel_data = get_scratch_bits(graphics, 0,
+            sizeof(*pixel_data) * gp_bound_rect.Width * gp_bound_rect.Height);
         if (!pixel_data)
             stat = OutOfMemory;
+        else
+            memset(pixel_data, 0, sizeof(*pixel_data) * gp_bound_rect.Width * gp_bound_rect.Height);
 
         if (stat == Ok)
         {
@@ -4689,8 +4756,6 @@ static GpStatus SOFTWARE_GdipFillRegion(GpGraphics *graphics, GpBrush *brush,
                     gp_bound_rect.Y, (BYTE*)pixel_data, gp_bound_rect.Width,
                     gp_bound_rect.Height, gp_bound_rect.Width * 4, hregion,
                     PixelFormat32bppARGB);
-
-            heap_free(pixel_data);
         }
 
         DeleteObject(hregion);
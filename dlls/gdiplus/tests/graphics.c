@@ -6653,6 +6653,69 @@ static void test_GdipFillRectanglesOnBitmapTextureBrush(void)
     GdipFree(src_img_data);
 }
 
+extern BOOL color_match(ARGB c1, ARGB c2, BYTE max_diff);
+
+static void test_alpha_fill_bitmap(void)
+{
+    static const struct
+    {
+        PixelFormat format;
+        ARGB expected;
+    }
+    tests[] =
+    {
+        {PixelFormat32bppARGB, 0xff80007f},
+        {PixelFormat32bppRGB,  0xff80007f},
+        {PixelFormat32bppPARGB, 0xff80007f},
+    };
+    GpSolidFill *brush;
+    GpGraphics *graphics;
+    GpBitmap *bitmap;
+    GpStatus status;
+    ARGB color;
+    UINT i;
+
+    for (i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        status = GdipCreateBitmapFromScan0(8, 8, 0, tests[i].format, NULL, &bitmap);
+        expect(Ok, status);
+        status = GdipGetImageGraphicsContext((GpImage *)bitmap, &graphics);
+        expect(Ok, status);
+
+        status = GdipCreateSolidFill(0xff0000ff, &brush);
+        expect(Ok, status);
+        status = GdipFillRectangleI(graphics, (GpBrush *)brush, 0, 0, 8, 8);
+        expect(Ok, status);
+        GdipDeleteBrush((GpBrush *)brush);
+
+        /* draw twice with different sizes, smaller fill last */
+        status = GdipCreateSolidFill(0x80ff0000, &brush);
+        expect(Ok, status);
+        status = GdipFillRectangleI(graphics, (GpBrush *)brush, 4, 4, 4, 4);
+        expect(Ok, status);
+        status = GdipFillRectangleI(graphics, (GpBrush *)brush, 1, 1, 2, 2);
+        expect(Ok, status);
+        GdipDeleteBrush((GpBrush *)brush);
+
+        GdipDeleteGraphics(graphics);
+
+        status = GdipBitmapGetPixel(bitmap, 0, 0, &color);
+        expect(Ok, status);
+        ok(color == 0xff0000ff, "%u: got color %08x\n", i, color);
+        status = GdipBitmapGetPixel(bitmap, 3, 3, &color);
+        expect(Ok, status);
+        ok(color == 0xff0000ff, "%u: got color %08x\n", i, color);
+        status = GdipBitmapGetPixel(bitmap, 1, 2, &color);
+        expect(Ok, status);
+        ok(color_match(color, tests[i].expected, 2), "%u: got color %08x\n", i, color);
+        status = GdipBitmapGetPixel(bitmap, 7, 7, &color);
+        expect(Ok, status);
+        ok(color_match(color, tests[i].expected, 2), "%u: got color %08x\n", i, color);
+
+        GdipDisposeImage((GpImage *)bitmap);
+    }
+}
+
 static void test_GdipDrawImagePointsRectOnMemoryDC(void)
 {
     ARGB color[6] = {0,0,0,0,0,0};
@@ -7312,6 +7375,7 @@ START_TEST(graphics)
     test_GdipFillRectanglesOnMemoryDCSolidBrush();
     test_GdipFillRectanglesOnMemoryDCTextureBrush();
     test_GdipFillRectanglesOnBitmapTextureBrush();
+    test_alpha_fill_bitmap();
     test_GdipDrawImagePointsRectOnMemoryDC();
     test_container_rects();
     test_GdipGraphicsSetAbort();
@@ -4903,6 +4903,82 @@ static void test_WriteFileGather(void)
     DeleteFileA( filename );
 }
 
+static void test_scatter_gather_pages(void)
+{
+    static const unsigned int count = 300;
+    char temp_path[MAX_PATH], filename[MAX_PATH];
+    FILE_SEGMENT_ELEMENT *fse;
+    HANDLE hfile, evt;
+    OVERLAPPED ovl;
+    SYSTEM_INFO si;
+    char *wbuf, *rbuf;
+    unsigned int i;
+    DWORD ret, tx;
+    BOOL br;
+
+    evt = CreateEventW( NULL, TRUE, FALSE, NULL );
+
+    ret = GetTempPathA( MAX_PATH, temp_path );
+    ok( ret != 0, "GetTempPathA error %ld\n", GetLastError() );
+    ret = GetTempFileNameA( temp_path, "wfg", 0, filename );
+    ok( ret != 0, "GetTempFileNameA error %ld\n", GetLastError() );
+
+    hfile = CreateFileA( filename, GENERIC_READ | GENERIC_WRITE, 0, 0, CREATE_ALWAYS,
+                         FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED | FILE_ATTRIBUTE_NORMAL, 0 );
+    ok( hfile != INVALID_HANDLE_VALUE, "CreateFile failed err %lu\n", GetLastError() );
+    if (hfile == INVALID_HANDLE_VALUE) return;
+
+    GetSystemInfo( &si );
+    wbuf = VirtualAlloc( NULL, count * si.dwPageSize, MEM_COMMIT, PAGE_READWRITE );
+    ok( wbuf != NULL, "VirtualAlloc failed err %lu\n", GetLastError() );
+    rbuf = VirtualAlloc( NULL, count * si.dwPageSize, MEM_COMMIT, PAGE_READWRITE );
+    ok( rbuf != NULL, "VirtualAlloc failed err %lu\n", GetLastError() );
+    fse = calloc( count + 1, sizeof(*fse) );
+
+    /* write the pages in reverse order */
+    for (i = 0; i < count; i++)
+    {
+        memset( wbuf + i * si.dwPageSize, i, si.dwPageSize );
+        fse[i].Buffer = wbuf + (count - 1 - i) * si.dwPageSize;
+    }
+    memset( &ovl, 0, sizeof(ovl) );
+    ovl.hEvent = evt;
+    SetLastError( 0xdeadbeef );
+    if (!WriteFileGather( hfile, fse, count * si.dwPageSize, NULL, &ovl ))
+        ok( GetLastError() == ERROR_IO_PENDING, "WriteFileGather failed err %lu\n", GetLastError() );
+    tx = 0;
+    br = GetOverlappedResult( hfile, &ovl, &tx, TRUE );
+    ok( br == TRUE, "GetOverlappedResult failed: %lu\n", GetLastError() );
+    ok( tx == count * si.dwPageSize, "got unexpected bytes transferred: %lu\n", tx );
+
+    /* read them back in order, starting one page into the file */
+    for (i = 0; i < count; i++) fse[i].Buffer = rbuf + i * si.dwPageSize;
+    memset( rbuf, 0xcc, count * si.dwPageSize );
+    memset( &ovl, 0, sizeof(ovl) );
+    ovl.hEvent = evt;
+    S(U(ovl)).Offset = si.dwPageSize;
+    SetLastError( 0xdeadbeef );
+    if (!ReadFileScatter( hfile, fse, count * si.dwPageSize, NULL, &ovl ))
+        ok( GetLastError() == ERROR_IO_PENDING, "ReadFileScatter failed err %lu\n", GetLastError() );
+    tx = 0;
+    br = GetOverlappedResult( hfile, &ovl, &tx, TRUE );
+    ok( br == TRUE, "GetOverlappedResult failed: %lu\n", GetLastError() );
+    ok( tx == (count - 1) * si.dwPageSize, "got unexpected bytes transferred: %lu\n", tx );
+
+    for (i = 0; i < count - 1; i++)
+        if (rbuf[i * si.dwPageSize] != (char)(count - 2 - i) ||
+            rbuf[(i + 1) * si.dwPageSize - 1] != (char)(count - 2 - i)) break;
+    ok( i == count - 1, "wrong data in page %u\n", i );
+    ok( rbuf[(count - 1) * si.dwPageSize] == (char)0xcc, "data should not have been read into the last page\n" );
+
+    free( fse );
+    VirtualFree( wbuf, 0, MEM_RELEASE );
+    VirtualFree( rbuf, 0, MEM_RELEASE );
+    CloseHandle( hfile );
+    CloseHandle( evt );
+    DeleteFileA( filename );
+}
+
 static unsigned file_map_access(unsigned access)
 {
     if (access & GENERIC_READ)    access |= FILE_GENERIC_READ;
@@ -6193,6 +6269,7 @@ START_TEST(file)
     test_OpenFileById();
     test_SetFileValidData();
     test_WriteFileGather();
+    test_scatter_gather_pages();
     test_file_access();
     test_GetFinalPathNameByHandleA();
     test_GetFinalPathNameByHandleW();
@@ -2139,9 +2139,10 @@ static void test_import_resolution(void)
     } data, *ptr;
     IMAGE_NT_HEADERS nt;
     IMAGE_SECTION_HEADER section;
+    BOOL bound = FALSE;
     int test;
 
-    for (test = 0; test < 3; test++)
+    for (test = 0; test < 5; test++)
     {
 #define DATA_RVA(ptr) (page_size + ((char *)(ptr) - (char *)&data))
         nt = nt_header_template;
@@ -2169,6 +2170,20 @@ static void test_import_resolution(void)
         strcpy( data.function.name, "CreateEventA" );
         data.original_thunks[0].u1.AddressOfData = DATA_RVA( &data.function );
         data.thunks[0].u1.AddressOfData = 0xdeadbeef;
+        if (test >= 3)
+        {
+            /* old style binding against the loaded kernel32 */
+            HMODULE kernel32 = GetModuleHandleA( data.module );
+            IMAGE_NT_HEADERS *kernel32_nt = pRtlImageNtHeader( kernel32 );
+
+            data.descr[0].TimeDateStamp = kernel32_nt->FileHeader.TimeDateStamp;
+            data.descr[0].ForwarderChain = ~0u;
+            /* a binding is only valid if the module is loaded at its preferred base */
+            bound = test == 3 && (ULONG_PTR)kernel32 == kernel32_nt->OptionalHeader.ImageBase;
+            /* something the loader would never resolve the import to */
+            data.thunks[0].u1.Function = 0x0badf00d;
+            if (test == 4) data.descr[0].TimeDateStamp++;  /* stale binding */
+        }
 
         data.tls.StartAddressOfRawData = nt.OptionalHeader.ImageBase + DATA_RVA( data.tls_data );
         data.tls.EndAddressOfRawData = data.tls.StartAddressOfRawData + sizeof(data.tls_data);
@@ -2245,6 +2260,18 @@ static void test_import_resolution(void)
             ok( ptr->tls_index == 9999, "wrong tls index %d\n", ptr->tls_index );
             FreeLibrary( mod );
             break;
+        case 3:  /* bound imports */
+        case 4:  /* stale bound imports are resolved again */
+            mod = LoadLibraryA( dll_name );
+            ok( mod != NULL, "failed to load err %lu\n", GetLastError() );
+            if (!mod) break;
+            ptr = (struct imports *)((char *)mod + page_size);
+            if (bound) expect = (void *)0x0badf00d;
+            else expect = GetProcAddress( GetModuleHandleA( data.module ), data.function.name );
+            ok( (void *)ptr->thunks[0].u1.Function == expect, "%u: thunk %p instead of %p for %s.%s\n",
+                test, (void *)ptr->thunks[0].u1.Function, expect, data.module, data.function.name );
+            FreeLibrary( mod );
+            break;
         }
         DeleteFileA( dll_name );
 #undef DATA_RVA
@@ -1432,6 +1432,41 @@ static void test_LdrGetDllFullName(void)
             wine_dbgstr_w(expected_path), wine_dbgstr_w(path_buffer) );
 }
 
+static void test_GetModuleHandle_names(void)
+{
+    WCHAR path[MAX_PATH], *p;
+    HMODULE kernel32, mod;
+
+    kernel32 = GetModuleHandleW( L"kernel32.dll" );
+    ok( !!kernel32, "kernel32 not found.\n" );
+
+    mod = GetModuleHandleW( L"KERNEL32.DLL" );
+    ok( mod == kernel32, "got %p, expected %p.\n", mod, kernel32 );
+    mod = GetModuleHandleW( L"Kernel32" );
+    ok( mod == kernel32, "got %p, expected %p.\n", mod, kernel32 );
+
+    GetModuleFileNameW( kernel32, path, ARRAY_SIZE(path) );
+    for (p = path; *p; p++) if (*p >= 'a' && *p <= 'z') *p += 'A' - 'a';
+    mod = GetModuleHandleW( path );
+    ok( mod == kernel32, "got %p, expected %p for %s.\n", mod, kernel32, wine_dbgstr_w(path) );
+
+    SetLastError( 0xdeadbeef );
+    mod = GetModuleHandleW( L"kernel32.dl" );
+    ok( !mod, "got %p.\n", mod );
+    ok( GetLastError() == ERROR_MOD_NOT_FOUND, "got error %lu.\n", GetLastError() );
+
+    if (GetModuleHandleW( L"msacm32.dll" ))
+    {
+        skip( "msacm32 is already loaded.\n" );
+        return;
+    }
+    mod = LoadLibraryW( L"msacm32.dll" );
+    ok( !!mod, "LoadLibrary failed, error %lu.\n", GetLastError() );
+    ok( GetModuleHandleW( L"MSACM32.DLL" ) == mod, "module not found.\n" );
+    FreeLibrary( mod );
+    ok( !GetModuleHandleW( L"msacm32.dll" ), "module still found after unload.\n" );
+}
+
 static void test_apisets(void)
 {
     static const struct
@@ -1643,6 +1678,7 @@ START_TEST(module)
     test_SetDefaultDllDirectories();
     test_LdrGetDllHandleEx();
     test_LdrGetDllFullName();
+    test_GetModuleHandle_names();
     test_apisets();
     test_ddag_node();
 }
@@ -4202,6 +4202,148 @@ static void test_exit_process_async(void)
     CloseHandle(server);
 }
 
+static DWORD CALLBACK blocking_read_proc(void *arg)
+{
+    HANDLE pipe = arg;
+    char buffer[64];
+    DWORD size;
+    BOOL ret;
+
+    /* read until the other end goes away */
+    do ret = ReadFile(pipe, buffer, sizeof(buffer), &size, NULL);
+    while (ret);
+    return GetLastError();
+}
+
+static void test_blocking_read_close(void)
+{
+    HANDLE server, client, thread;
+    DWORD ret, size, error;
+    unsigned int i;
+
+    /* closing the other end has to wake up a blocked reader however the two race */
+    for (i = 0; i < 100; i++)
+    {
+        server = CreateNamedPipeA(PIPENAME, PIPE_ACCESS_DUPLEX, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+                                  1, 1024, 1024, NMPWAIT_USE_DEFAULT_WAIT, NULL);
+        ok(server != INVALID_HANDLE_VALUE, "CreateNamedPipe failed with %lu\n", GetLastError());
+        client = CreateFileA(PIPENAME, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, 0);
+        ok(client != INVALID_HANDLE_VALUE, "CreateFile failed with %lu\n", GetLastError());
+
+        ret = WriteFile(i & 1 ? client : server, "data", 4, &size, NULL);
+        ok(ret, "WriteFile failed with %lu\n", GetLastError());
+
+        thread = CreateThread(NULL, 0, blocking_read_proc, i & 1 ? server : client, 0, NULL);
+        Sleep(i % 3);
+        CloseHandle(i & 1 ? client : server);
+
+        ret = WaitForSingleObject(thread, 5000);
+        ok(!ret, "%u: reader is still blocked\n", i);
+        if (ret)
+        {
+            TerminateThread(thread, 0);
+            WaitForSingleObject(thread, INFINITE);
+        }
+        else
+        {
+            GetExitCodeThread(thread, &error);
+            ok(error == ERROR_BROKEN_PIPE, "%u: got error %lu\n", i, error);
+        }
+        CloseHandle(thread);
+        CloseHandle(i & 1 ? server : client);
+    }
+}
+
+static void child_process_write_forever(const char *name)
+{
+    char buffer[4096];
+    HANDLE pipe;
+    DWORD size;
+
+    pipe = CreateFileA(name, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, 0);
+    ok(pipe != INVALID_HANDLE_VALUE, "CreateFile failed with %lu\n", GetLastError());
+
+    memset(buffer, 'x', sizeof(buffer));
+    /* write until the parent process terminates this process */
+    while (WriteFile(pipe, buffer, sizeof(buffer), &size, NULL));
+    ok(0, "WriteFile failed with %lu\n", GetLastError());
+}
+
+static void test_terminated_writer(void)
+{
+    PROCESS_INFORMATION info;
+    STARTUPINFOA si = { sizeof(si) };
+    char **argv, cmdline[MAX_PATH + 64], buffer[4096];
+    HANDLE server, client, thread;
+    unsigned int i, j;
+    DWORD ret, size;
+
+    winetest_get_mainargs(&argv);
+
+    server = CreateNamedPipeA(PIPENAME, PIPE_ACCESS_DUPLEX, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+                              1, 65536, 65536, NMPWAIT_USE_DEFAULT_WAIT, NULL);
+    ok(server != INVALID_HANDLE_VALUE, "CreateNamedPipe failed with %lu\n", GetLastError());
+
+    /* a writer killed in the middle of a transfer must not leave the pipe unusable */
+    for (i = 0; i < 5; i++)
+    {
+        sprintf(cmdline, "\"%s\" pipe write_forever %s", argv[0], PIPENAME);
+        ret = CreateProcessA(NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &info);
+        ok(ret, "CreateProcess failed with %lu\n", GetLastError());
+        CloseHandle(info.hThread);
+
+        ret = ConnectNamedPipe(server, NULL);
+        ok(ret || GetLastError() == ERROR_PIPE_CONNECTED, "ConnectNamedPipe failed with %lu\n", GetLastError());
+        for (j = 0; j < 10 * (i + 1); j++)
+        {
+            ret = ReadFile(server, buffer, sizeof(buffer), &size, NULL);
+            ok(ret, "ReadFile failed with %lu\n", GetLastError());
+        }
+
+        TerminateProcess(info.hProcess, 0);
+        WaitForSingleObject(info.hProcess, INFINITE);
+        CloseHandle(info.hProcess);
+
+        thread = CreateThread(NULL, 0, blocking_read_proc, server, 0, NULL);
+        ret = WaitForSingleObject(thread, 5000);
+        ok(!ret, "%u: reader is still blocked\n", i);
+        if (ret)
+        {
+            TerminateThread(thread, 0);
+            WaitForSingleObject(thread, INFINITE);
+        }
+        else
+        {
+            GetExitCodeThread(thread, &ret);
+            ok(ret == ERROR_BROKEN_PIPE, "%u: got error %lu\n", i, ret);
+        }
+        CloseHandle(thread);
+
+        ret = DisconnectNamedPipe(server);
+        ok(ret, "DisconnectNamedPipe failed with %lu\n", GetLastError());
+    }
+
+    client = CreateFileA(PIPENAME, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, 0);
+    ok(client != INVALID_HANDLE_VALUE, "CreateFile failed with %lu\n", GetLastError());
+
+    ret = WriteFile(client, "ping", 4, &size, NULL);
+    ok(ret, "WriteFile failed with %lu\n", GetLastError());
+    memset(buffer, 0, sizeof(buffer));
+    ret = ReadFile(server, buffer, sizeof(buffer), &size, NULL);
+    ok(ret, "ReadFile failed with %lu\n", GetLastError());
+    ok(size == 4 && !memcmp(buffer, "ping", 4), "got %lu bytes %s\n", size, debugstr_an(buffer, size));
+
+    ret = WriteFile(server, "pong", 4, &size, NULL);
+    ok(ret, "WriteFile failed with %lu\n", GetLastError());
+    memset(buffer, 0, sizeof(buffer));
+    ret = ReadFile(client, buffer, sizeof(buffer), &size, NULL);
+    ok(ret, "ReadFile failed with %lu\n", GetLastError());
+    ok(size == 4 && !memcmp(buffer, "pong", 4), "got %lu bytes %s\n", size, debugstr_an(buffer, size));
+
+    CloseHandle(client);
+    CloseHandle(server);
+}
+
 START_TEST(pipe)
 {
     char **argv;
@@ -4253,6 +4395,11 @@ START_TEST(pipe)
             child_process_exit_process_async(pid, handle);
             return;
         }
+        if (!strcmp(argv[2], "write_forever"))
+        {
+            child_process_write_forever(argv[3]);
+            return;
+        }
     }
 
     if (test_DisconnectNamedPipe())
@@ -4282,4 +4429,6 @@ START_TEST(pipe)
     test_nowait(PIPE_TYPE_MESSAGE);
     test_GetOverlappedResultEx();
     test_exit_process_async();
+    test_blocking_read_close();
+    test_terminated_writer();
 }
@@ -4389,6 +4389,49 @@ static void test_dead_process(void)
     CloseHandle(pi.hThread);
 }
 
+/* WINEZYGOTE=1 makes Wine create processes by forking them from a zygote process */
+static void test_zygote(void)
+{
+    char buffer[MAX_PATH + 32], value[8];
+    LARGE_INTEGER freq, start, end, total;
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = {0};
+    DWORD ret, exit_code;
+    int i, count = 10;
+
+    if (!GetEnvironmentVariableA("WINEZYGOTE", value, sizeof(value)) || !atoi(value))
+    {
+        skip("WINEZYGOTE is not set\n");
+        return;
+    }
+
+    si.cb = sizeof(si);
+    QueryPerformanceFrequency(&freq);
+    total.QuadPart = 0;
+    sprintf(buffer, "\"%s\" process zygote \"a b\" c", selfname);
+
+    /* the first process starts the zygote, the others should be forked from it */
+    for (i = 0; i <= count; i++)
+    {
+        QueryPerformanceCounter(&start);
+        ret = CreateProcessA(NULL, buffer, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi);
+        ok(ret, "CreateProcess failed, error %lu\n", GetLastError());
+        ret = WaitForSingleObject(pi.hProcess, 30000);
+        ok(ret == WAIT_OBJECT_0, "WaitForSingleObject returned %lu\n", ret);
+        QueryPerformanceCounter(&end);
+        if (i) total.QuadPart += end.QuadPart - start.QuadPart;
+
+        ret = GetExitCodeProcess(pi.hProcess, &exit_code);
+        ok(ret, "GetExitCodeProcess failed, error %lu\n", GetLastError());
+        ok(!exit_code, "child %d failed %lu tests\n", i, exit_code);
+        CloseHandle(pi.hThread);
+        CloseHandle(pi.hProcess);
+    }
+
+    trace("average time to run a child process: %.2f ms\n",
+          (double)total.QuadPart * 1000 / freq.QuadPart / count);
+}
+
 static void test_nested_jobs_child(unsigned int index)
 {
     JOBOBJECT_ASSOCIATE_COMPLETION_PORT port_info;
@@ -5034,6 +5077,13 @@ START_TEST(process)
             test_handle_list_attribute(TRUE, h, h2);
             return;
         }
+        else if (!strcmp(myARGV[2], "zygote"))
+        {
+            ok(myARGC == 5, "got %d arguments\n", myARGC);
+            ok(myARGC < 4 || !strcmp(myARGV[3], "a b"), "got %s\n", myARGV[3]);
+            ok(myARGC < 5 || !strcmp(myARGV[4], "c"), "got %s\n", myARGV[4]);
+            return;
+        }
         else if (!strcmp(myARGV[2], "nested_jobs") && myARGC >= 4)
         {
             test_nested_jobs_child(atoi(myARGV[3]));
@@ -5088,6 +5138,7 @@ START_TEST(process)
     test_parent_process_attribute(0, NULL);
     test_handle_list_attribute(FALSE, NULL, NULL);
     test_dead_process();
+    test_zygote();
 
     /* things that can be tested:
      *  lookup:         check the way program to be executed is searched
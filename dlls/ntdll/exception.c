@@ -306,6 +306,21 @@ static RTL_CRITICAL_SECTION_DEBUG dynamic_unwind_debug =
 };
 static RTL_CRITICAL_SECTION dynamic_unwind_section = { &dynamic_unwind_debug, -1, 0, 0, 0, 0 };
 
+/* cache of the function table lookups in PE modules, indexed by pc */
+#define FUNCTION_CACHE_SIZE 256
+
+struct function_cache_entry
+{
+    ULONG_PTR             pc;
+    ULONG_PTR             base;
+    RUNTIME_FUNCTION     *func;
+    LDR_DATA_TABLE_ENTRY *module;
+};
+
+static struct function_cache_entry function_cache[FUNCTION_CACHE_SIZE];
+static ULONG function_cache_generation;  /* incremented when a module is unloaded */
+static RTL_SRWLOCK function_cache_lock = RTL_SRWLOCK_INIT;
+
 static ULONG_PTR get_runtime_function_end( RUNTIME_FUNCTION *func, ULONG_PTR addr )
 {
 #ifdef __x86_64__
@@ -554,6 +569,60 @@ static RUNTIME_FUNCTION *find_function_info( ULONG_PTR pc, ULONG_PTR base,
     return NULL;
 }
 
+static inline struct function_cache_entry *get_function_cache_entry( ULONG_PTR pc )
+{
+    return &function_cache[(pc ^ (pc >> 12)) % FUNCTION_CACHE_SIZE];
+}
+
+/* look for a previous lookup of the same pc in a PE module */
+static BOOL lookup_function_cache( ULONG_PTR pc, ULONG_PTR *base, RUNTIME_FUNCTION **func,
+                                   LDR_DATA_TABLE_ENTRY **module )
+{
+    struct function_cache_entry *entry = get_function_cache_entry( pc );
+    BOOL ret = FALSE;
+
+    RtlAcquireSRWLockShared( &function_cache_lock );
+    if (entry->pc == pc && entry->module)
+    {
+        *base   = entry->base;
+        *func   = entry->func;
+        *module = entry->module;
+        ret = TRUE;
+    }
+    RtlReleaseSRWLockShared( &function_cache_lock );
+    return ret;
+}
+
+static void add_function_cache( ULONG_PTR pc, ULONG_PTR base, RUNTIME_FUNCTION *func,
+                                LDR_DATA_TABLE_ENTRY *module, ULONG generation )
+{
+    struct function_cache_entry *entry = get_function_cache_entry( pc );
+
+    RtlAcquireSRWLockExclusive( &function_cache_lock );
+    /* don't add anything found in a module that has been unloaded since */
+    if (generation == function_cache_generation)
+    {
+        entry->pc     = pc;
+        entry->base   = base;
+        entry->func   = func;
+        entry->module = module;
+    }
+    RtlReleaseSRWLockExclusive( &function_cache_lock );
+}
+
+/**********************************************************************
+ *           flush_function_cache
+ *
+ * Called by the loader when a module is unloaded.
+ */
+void flush_function_cache(void)
+{
+    RtlAcquireSRWLockExclusive( &function_cache_lock );
+    memset( function_cache, 0, sizeof(function_cache) );
+    function_cache_generation++;
+    RtlReleaseSRWLockExclusive( &function_cache_lock );
+}
+
 /**********************************************************************
  *           lookup_function_info
  */
@@ -561,7 +630,9 @@ RUNTIME_FUNCTION *lookup_function_info( ULONG_PTR pc, ULONG_PTR *base, LDR_DATA_
 {
     RUNTIME_FUNCTION *func = NULL;
     struct dynamic_unwind_entry *entry;
-    ULONG size;
+    ULONG size, generation = function_cache_generation;
+
+    if (lookup_function_cache( pc, base, &func, module )) return func;
 
     /* PE module or wine module */
     if (!LdrFindEntryForAddress( (void *)pc, module ))
@@ -573,6 +644,7 @@ RUNTIME_FUNCTION *lookup_function_info( ULONG_PTR pc, ULONG_PTR *base, LDR_DATA_
             /* lookup in function table */
             func = find_function_info( pc, (ULONG_PTR)(*module)->DllBase, func, size/sizeof(*func) );
         }
+        add_function_cache( pc, *base, func, *module, generation );
     }
     else
     {
@@ -606,13 +678,42 @@ PRUNTIME_FUNCTION WINAPI RtlLookupFunctionEntry( ULONG_PTR pc, ULONG_PTR *base,
 {
     LDR_DATA_TABLE_ENTRY *module;
     RUNTIME_FUNCTION *func;
+    ULONG_PTR start, end;
+    ULONG i;
 
-    /* FIXME: should use the history table to make things faster */
+    /* the history table remembers the functions of the previous unwinds */
+    if (table && table->Search != UNWIND_HISTORY_TABLE_NONE &&
+        pc >= table->LowAddress && pc < table->HighAddress)
+    {
+        for (i = 0; i < table->Count && i < UNWIND_HISTORY_TABLE_SIZE; i++)
+        {
+            func = table->Entry[i].FunctionEntry;
+            start = table->Entry[i].ImageBase + func->BeginAddress;
+            end = table->Entry[i].ImageBase + get_runtime_function_end( func, table->Entry[i].ImageBase );
+            if (pc >= start && pc < end)
+            {
+                *base = table->Entry[i].ImageBase;
+                return func;
+            }
+        }
+    }
 
     if (!(func = lookup_function_info( pc, base, &module )))
     {
         *base = 0;
         WARN( "no exception table found for %lx\n", pc );
+        return NULL;
+    }
+
+    if (table && table->Search == UNWIND_HISTORY_TABLE_NONE && table->Count < UNWIND_HISTORY_TABLE_SIZE)
+    {
+        start = *base + func->BeginAddress;
+        end = *base + get_runtime_function_end( func, *base );
+        table->Entry[table->Count].ImageBase = *base;
+        table->Entry[table->Count].FunctionEntry = func;
+        if (start < table->LowAddress) table->LowAddress = start;
+        if (end > table->HighAddress) table->HighAddress = end;
+        table->Count++;
     }
     return func;
 }
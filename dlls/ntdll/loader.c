@@ -136,6 +136,9 @@ typedef struct _wine_modref
     ULONG                 CheckSum;
     BOOL                  system;
     BOOL                  is_hybrid;
+    struct list           basename_entry;  /* entry in the base name hash table */
+    struct list           fullname_entry;  /* entry in the full name hash table */
+    struct list           fileid_entry;    /* entry in the file id hash table */
 } WINE_MODREF;
 
 static UINT tls_module_count;      /* number of modules with TLS directory */
@@ -186,6 +189,26 @@ static WINE_MODREF *last_failed_modref;
 
 static LDR_DDAG_NODE *node_ntdll, *node_kernel32;
 
+/* address ranges of the loaded modules, sorted by address */
+struct module_range
+{
+    ULONG_PTR             start;
+    ULONG_PTR             end;
+    LDR_DATA_TABLE_ENTRY *ldr;
+};
+
+static struct module_range *module_ranges;
+static unsigned int module_range_count;
+static unsigned int module_range_size;
+static RTL_SRWLOCK module_ranges_lock = RTL_SRWLOCK_INIT;
+
+/* hash tables of the loaded modules, protected by the loader_section */
+#define MODULE_HASH_SIZE 64
+
+static struct list basename_hash[MODULE_HASH_SIZE];
+static struct list fullname_hash[MODULE_HASH_SIZE];
+static struct list fileid_hash[MODULE_HASH_SIZE];
+
 static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD flags, WINE_MODREF** pwm, BOOL system );
 static NTSTATUS process_attach( LDR_DDAG_NODE *node, LPVOID lpReserved );
 static FARPROC find_ordinal_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
@@ -475,6 +498,187 @@ static void call_ldr_notifications( ULONG reason, LDR_DATA_TABLE_ENTRY *module )
     }
 }
 
+/*************************************************************************
+ *		find_module_range
+ *
+ * Find the index of the first module range that ends after the address.
+ * The module_ranges_lock must be held while calling this function.
+ */
+static unsigned int find_module_range( ULONG_PTR addr )
+{
+    unsigned int min = 0, max = module_range_count, pos;
+
+    while (min < max)
+    {
+        pos = (min + max) / 2;
+        if (module_ranges[pos].end <= addr) min = pos + 1;
+        else max = pos;
+    }
+    return min;
+}
+
+
+/*************************************************************************
+ *		find_module_range_entry
+ *
+ * Find the module containing the address, without needing the loader_section.
+ */
+static LDR_DATA_TABLE_ENTRY *find_module_range_entry( const void *addr )
+{
+    LDR_DATA_TABLE_ENTRY *ret = NULL;
+    unsigned int pos;
+
+    RtlAcquireSRWLockShared( &module_ranges_lock );
+    pos = find_module_range( (ULONG_PTR)addr );
+    if (pos < module_range_count && module_ranges[pos].start <= (ULONG_PTR)addr) ret = module_ranges[pos].ldr;
+    RtlReleaseSRWLockShared( &module_ranges_lock );
+    return ret;
+}
+
+
+/*************************************************************************
+ *		add_module_range
+ *
+ * Add a module to the address range index.
+ * The loader_section must be locked while calling this function.
+ */
+static BOOL add_module_range( LDR_DATA_TABLE_ENTRY *ldr )
+{
+    ULONG_PTR start = (ULONG_PTR)ldr->DllBase;
+    struct module_range *new_ranges;
+    unsigned int new_size, pos;
+    BOOL ret = TRUE;
+
+    RtlAcquireSRWLockExclusive( &module_ranges_lock );
+    if (module_range_count == module_range_size)
+    {
+        new_size = max( 32, module_range_size * 2 );
+        if (module_ranges)
+            new_ranges = RtlReAllocateHeap( GetProcessHeap(), 0, module_ranges, new_size * sizeof(*new_ranges) );
+        else
+            new_ranges = RtlAllocateHeap( GetProcessHeap(), 0, new_size * sizeof(*new_ranges) );
+        if (new_ranges)
+        {
+            module_ranges = new_ranges;
+            module_range_size = new_size;
+        }
+        else ret = FALSE;
+    }
+    if (ret)
+    {
+        pos = find_module_range( start );
+        memmove( &module_ranges[pos + 1], &module_ranges[pos], (module_range_count - pos) * sizeof(*module_ranges) );
+        module_ranges[pos].start = start;
+        module_ranges[pos].end = start + ldr->SizeOfImage;
+        module_ranges[pos].ldr = ldr;
+        module_range_count++;
+    }
+    RtlReleaseSRWLockExclusive( &module_ranges_lock );
+    return ret;
+}
+
+
+/*************************************************************************
+ *		remove_module_range
+ *
+ * Remove a module from the address range index.
+ * The loader_section must be locked while calling this function.
+ */
+static void remove_module_range( LDR_DATA_TABLE_ENTRY *ldr )
+{
+    unsigned int pos;
+
+    RtlAcquireSRWLockExclusive( &module_ranges_lock );
+    pos = find_module_range( (ULONG_PTR)ldr->DllBase );
+    if (pos < module_range_count && module_ranges[pos].ldr == ldr)
+    {
+        module_range_count--;
+        memmove( &module_ranges[pos], &module_ranges[pos + 1], (module_range_count - pos) * sizeof(*module_ranges) );
+    }
+    RtlReleaseSRWLockExclusive( &module_ranges_lock );
+}
+
+
+/*************************************************************************
+ *		hash_module_name
+ *
+ * Case-insensitive hash of a module name, consistent with RtlEqualUnicodeString.
+ */
+static unsigned int hash_module_name( const UNICODE_STRING *name )
+{
+    unsigned int i, hash = 0;
+
+    for (i = 0; i < name->Length / sizeof(WCHAR); i++)
+        hash = hash * 31 + RtlUpcaseUnicodeChar( name->Buffer[i] );
+    return hash % MODULE_HASH_SIZE;
+}
+
+
+static unsigned int hash_file_id( const struct file_id *id )
+{
+    unsigned int i, hash = 0;
+
+    for (i = 0; i < sizeof(id->ObjectId); i++) hash = hash * 31 + id->ObjectId[i];
+    return hash % MODULE_HASH_SIZE;
+}
+
+
+/*************************************************************************
+ *		init_module_hash
+ */
+static void init_module_hash(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < MODULE_HASH_SIZE; i++)
+    {
+        list_init( &basename_hash[i] );
+        list_init( &fullname_hash[i] );
+        list_init( &fileid_hash[i] );
+    }
+}
+
+
+/*************************************************************************
+ *		add_module_hash
+ *
+ * Add a module to the name and file id hash tables.
+ * The loader_section must be locked while calling this function.
+ */
+static void add_module_hash( WINE_MODREF *wm )
+{
+    list_add_tail( &basename_hash[hash_module_name( &wm->ldr.BaseDllName )], &wm->basename_entry );
+    list_add_tail( &fullname_hash[hash_module_name( &wm->ldr.FullDllName )], &wm->fullname_entry );
+    list_add_tail( &fileid_hash[hash_file_id( &wm->id )], &wm->fileid_entry );
+}
+
+
+/*************************************************************************
+ *		remove_module_hash
+ *
+ * The loader_section must be locked while calling this function.
+ */
+static void remove_module_hash( WINE_MODREF *wm )
+{
+    list_remove( &wm->basename_entry );
+    list_remove( &wm->fullname_entry );
+    list_remove( &wm->fileid_entry );
+}
+
+
+/*************************************************************************
+ *		set_module_file_id
+ *
+ * The loader_section must be locked while calling this function.
+ */
+static void set_module_file_id( WINE_MODREF *wm, const struct file_id *id )
+{
+    wm->id = *id;
+    list_remove( &wm->fileid_entry );
+    list_add_tail( &fileid_hash[hash_file_id( id )], &wm->fileid_entry );
+}
+
+
 /*************************************************************************
  *		get_modref
  *
@@ -483,19 +687,12 @@ static void call_ldr_notifications( ULONG reason, LDR_DATA_TABLE_ENTRY *module )
  */
 static WINE_MODREF *get_modref( HMODULE hmod )
 {
-    PLIST_ENTRY mark, entry;
-    PLDR_DATA_TABLE_ENTRY mod;
+    LDR_DATA_TABLE_ENTRY *mod;
 
     if (cached_modref && cached_modref->ldr.DllBase == hmod) return cached_modref;
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InMemoryOrderModuleList;
-    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
-    {
-        mod = CONTAINING_RECORD(entry, LDR_DATA_TABLE_ENTRY, InMemoryOrderLinks);
-        if (mod->DllBase == hmod)
-            return cached_modref = CONTAINING_RECORD(mod, WINE_MODREF, ldr);
-    }
-    return NULL;
+    if (!(mod = find_module_range_entry( hmod )) || mod->DllBase != hmod) return NULL;
+    return cached_modref = CONTAINING_RECORD(mod, WINE_MODREF, ldr);
 }
 
 
@@ -507,21 +704,19 @@ static WINE_MODREF *get_modref( HMODULE hmod )
  */
 static WINE_MODREF *find_basename_module( LPCWSTR name )
 {
-    PLIST_ENTRY mark, entry;
     UNICODE_STRING name_str;
+    WINE_MODREF *mod;
 
     RtlInitUnicodeString( &name_str, name );
 
     if (cached_modref && RtlEqualUnicodeString( &name_str, &cached_modref->ldr.BaseDllName, TRUE ))
         return cached_modref;
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InLoadOrderModuleList;
-    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
+    LIST_FOR_EACH_ENTRY( mod, &basename_hash[hash_module_name( &name_str )], WINE_MODREF, basename_entry )
     {
-        WINE_MODREF *mod = CONTAINING_RECORD(entry, WINE_MODREF, ldr.InLoadOrderLinks);
         if (RtlEqualUnicodeString( &name_str, &mod->ldr.BaseDllName, TRUE ) && !mod->system)
         {
-            cached_modref = CONTAINING_RECORD(mod, WINE_MODREF, ldr);
+            cached_modref = mod;
             return cached_modref;
         }
     }
@@ -537,8 +732,8 @@ static WINE_MODREF *find_basename_module( LPCWSTR name )
  */
 static WINE_MODREF *find_fullname_module( const UNICODE_STRING *nt_name )
 {
-    PLIST_ENTRY mark, entry;
     UNICODE_STRING name = *nt_name;
+    WINE_MODREF *mod;
 
     if (name.Length <= 4 * sizeof(WCHAR)) return NULL;
     name.Length -= 4 * sizeof(WCHAR);  /* for \??\ prefix */
@@ -547,13 +742,11 @@ static WINE_MODREF *find_fullname_module( const UNICODE_STRING *nt_name )
     if (cached_modref && RtlEqualUnicodeString( &name, &cached_modref->ldr.FullDllName, TRUE ))
         return cached_modref;
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InLoadOrderModuleList;
-    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
+    LIST_FOR_EACH_ENTRY( mod, &fullname_hash[hash_module_name( &name )], WINE_MODREF, fullname_entry )
     {
-        LDR_DATA_TABLE_ENTRY *mod = CONTAINING_RECORD(entry, LDR_DATA_TABLE_ENTRY, InLoadOrderLinks);
-        if (RtlEqualUnicodeString( &name, &mod->FullDllName, TRUE ))
+        if (RtlEqualUnicodeString( &name, &mod->ldr.FullDllName, TRUE ))
         {
-            cached_modref = CONTAINING_RECORD(mod, WINE_MODREF, ldr);
+            cached_modref = mod;
             return cached_modref;
         }
     }
@@ -569,16 +762,12 @@ static WINE_MODREF *find_fullname_module( const UNICODE_STRING *nt_name )
  */
 static WINE_MODREF *find_fileid_module( const struct file_id *id )
 {
-    LIST_ENTRY *mark, *entry;
+    WINE_MODREF *wm;
 
     if (cached_modref && !memcmp( &cached_modref->id, id, sizeof(*id) )) return cached_modref;
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InLoadOrderModuleList;
-    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
+    LIST_FOR_EACH_ENTRY( wm, &fileid_hash[hash_file_id( id )], WINE_MODREF, fileid_entry )
     {
-        LDR_DATA_TABLE_ENTRY *mod = CONTAINING_RECORD( entry, LDR_DATA_TABLE_ENTRY, InLoadOrderLinks );
-        WINE_MODREF *wm = CONTAINING_RECORD( mod, WINE_MODREF, ldr );
-
         if (!memcmp( &wm->id, id, sizeof(*id) ))
         {
             cached_modref = wm;
@@ -1085,6 +1274,74 @@ int CDECL __wine_is_module_hybrid( HMODULE module )
 
 #endif
 
+/*************************************************************************
+ *		is_bound_module_valid
+ *
+ * Check that a module an image was bound against is loaded at its preferred
+ * base and has the time stamp recorded at bind time.
+ */
+static BOOL is_bound_module_valid( const WINE_MODREF *wm, DWORD timestamp )
+{
+    const IMAGE_NT_HEADERS *nt = RtlImageNtHeader( wm->ldr.DllBase );
+
+    if (!nt || nt->FileHeader.TimeDateStamp != timestamp) return FALSE;
+    if ((ULONG_PTR)wm->ldr.DllBase != nt->OptionalHeader.ImageBase) return FALSE;
+    return !is_hybrid_module( wm );
+}
+
+
+/*************************************************************************
+ *		is_import_bound
+ *
+ * Check if the import address table of an import descriptor has been
+ * pre-resolved by a bind tool against the module that got loaded, in which
+ * case the imports don't need to be looked up again.
+ * The loader_section must be locked while calling this function.
+ */
+static BOOL is_import_bound( HMODULE module, const IMAGE_IMPORT_DESCRIPTOR *descr, const WINE_MODREF *wmImp )
+{
+    const IMAGE_BOUND_IMPORT_DESCRIPTOR *bound, *start;
+    const IMAGE_BOUND_FORWARDER_REF *ref;
+    const char *name = get_rva( module, descr->Name );
+    WCHAR buffer[256];
+    WINE_MODREF *wm;
+    DWORD size, i;
+
+    if (!descr->TimeDateStamp || !descr->u.OriginalFirstThunk) return FALSE;
+    if (TRACE_ON(relay) || TRACE_ON(snoop)) return FALSE;
+    if (is_hybrid_module( get_modref( module ))) return FALSE;
+
+    if (descr->TimeDateStamp != ~0u)  /* old style binding */
+        return descr->ForwarderChain == ~0u && is_bound_module_valid( wmImp, descr->TimeDateStamp );
+
+    /* new style binding, the time stamps are in the bound import directory */
+    if (!(start = RtlImageDirectoryEntryToData( module, TRUE, IMAGE_DIRECTORY_ENTRY_BOUND_IMPORT, &size )))
+        return FALSE;
+
+    for (bound = start; (const char *)(bound + 1) <= (const char *)start + size && bound->OffsetModuleName;
+         bound = (const IMAGE_BOUND_IMPORT_DESCRIPTOR *)(ref + bound->NumberOfModuleForwarderRefs))
+    {
+        ref = (const IMAGE_BOUND_FORWARDER_REF *)(bound + 1);
+        if ((const char *)(ref + bound->NumberOfModuleForwarderRefs) > (const char *)start + size) return FALSE;
+        if (_stricmp( (const char *)start + bound->OffsetModuleName, name )) continue;
+
+        if (!is_bound_module_valid( wmImp, bound->TimeDateStamp )) return FALSE;
+
+        /* the modules providing forwarded exports must not have changed either */
+        for (i = 0; i < bound->NumberOfModuleForwarderRefs; i++)
+        {
+            const char *fwd_name = (const char *)start + ref[i].OffsetModuleName;
+
+            if (build_import_name( buffer, fwd_name, strlen(fwd_name) )) return FALSE;
+            if (!(wm = find_basename_module( buffer ))) return FALSE;
+            if (!is_bound_module_valid( wm, ref[i].TimeDateStamp )) return FALSE;
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+
 /*************************************************************************
  *		import_dll
  *
@@ -1173,6 +1430,13 @@ static BOOL import_dll( HMODULE module, const IMAGE_IMPORT_DESCRIPTOR *descr, LP
         goto done;
     }
 
+    if (is_import_bound( module, descr, wmImp ))
+    {
+        TRACE_(imports)( "using bound imports of %s for %s\n",
+                         name, debugstr_w(current_modref->ldr.FullDllName.Buffer) );
+        goto done;
+    }
+
     while (import_list->u1.Ordinal)
     {
         if (IMAGE_SNAP_BY_ORDINAL(import_list->u1.Ordinal))
@@ -1581,6 +1845,16 @@ static WINE_MODREF *alloc_module( HMODULE hModule, const UNICODE_STRING *nt_name
             wm->ldr.EntryPoint = (char *)hModule + nt->OptionalHeader.AddressOfEntryPoint;
     }
 
+    /* lookups in the range index don't take the loader lock, so only publish the complete entry */
+    if (!add_module_range( &wm->ldr ))
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, wm->ldr.DdagNode );
+        RtlFreeHeap( GetProcessHeap(), 0, buffer );
+        RtlFreeHeap( GetProcessHeap(), 0, wm );
+        return NULL;
+    }
+    add_module_hash( wm );
+
     InsertTailList(&NtCurrentTeb()->Peb->LdrData->InLoadOrderModuleList,
                    &wm->ldr.InLoadOrderLinks);
     InsertTailList(&NtCurrentTeb()->Peb->LdrData->InMemoryOrderModuleList,
@@ -1674,6 +1948,32 @@ static void call_tls_callbacks( HMODULE module, UINT reason )
     }
 }
 
+/*************************************************************************
+ *              startup_trace_start
+ *
+ * Return the start time of a traced loader phase, or 0 if the startup trace is disabled.
+ */
+static LONGLONG startup_trace_start(void)
+{
+    LARGE_INTEGER counter;
+
+    if (!unix_funcs->startup_trace) return 0;
+    NtQueryPerformanceCounter( &counter, NULL );
+    return counter.QuadPart;
+}
+
+
+/*************************************************************************
+ *              startup_trace
+ *
+ * Record a loader phase in the startup trace.
+ */
+static void startup_trace( const char *name, const WCHAR *module, LONGLONG start )
+{
+    if (start) unix_funcs->startup_trace( name, module, start, GetCurrentThreadId() );
+}
+
+
 /*************************************************************************
  *              MODULE_InitDLL
  */
@@ -1684,6 +1984,7 @@ static NTSTATUS MODULE_InitDLL( WINE_MODREF *wm, UINT reason, LPVOID lpReserved
     DLLENTRYPROC entry = wm->ldr.EntryPoint;
     void *module = wm->ldr.DllBase;
     BOOL retv = FALSE;
+    LONGLONG start;
 
     /* Skip calls for modules loaded with special load flags */
 
@@ -1693,14 +1994,19 @@ static NTSTATUS MODULE_InitDLL( WINE_MODREF *wm, UINT reason, LPVOID lpReserved
         unix_funcs->init_builtin_dll( wm->ldr.DllBase );
     if (!entry) return STATUS_SUCCESS;
 
-    if (TRACE_ON(relay))
+    start = reason == DLL_PROCESS_ATTACH ? startup_trace_start() : 0;
+
+    /* the entry point may unload the module, so copy the name if it's needed afterwards */
+    if (TRACE_ON(relay) || start)
     {
         size_t len = min( wm->ldr.BaseDllName.Length, sizeof(mod_name)-sizeof(WCHAR) );
         memcpy( mod_name, wm->ldr.BaseDllName.Buffer, len );
         mod_name[len / sizeof(WCHAR)] = 0;
+    }
+
+    if (TRACE_ON(relay))
         TRACE_(relay)("\1Call PE DLL (proc=%p,module=%p %s,reason=%s,res=%p)\n",
                       entry, module, debugstr_w(mod_name), reason_names[reason], lpReserved );
-    }
     else TRACE("(%p %s,%s,%p) - CALL\n", module, debugstr_w(wm->ldr.BaseDllName.Buffer),
                reason_names[reason], lpReserved );
 
@@ -1721,6 +2027,7 @@ static NTSTATUS MODULE_InitDLL( WINE_MODREF *wm, UINT reason, LPVOID lpReserved
     /* The state of the module list may have changed due to the call
        to the dll. We cannot assume that this module has not been
        deleted.  */
+    startup_trace( "DllMain", mod_name, start );
     if (TRACE_ON(relay))
         TRACE_(relay)("\1Ret  PE DLL (proc=%p,module=%p %s,reason=%s,res=%p) retval=%x\n",
                       entry, module, debugstr_w(mod_name), reason_names[reason], lpReserved, retv );
@@ -1918,21 +2225,11 @@ NTSTATUS WINAPI LdrDisableThreadCalloutsForDll(HMODULE hModule)
  */
 NTSTATUS WINAPI LdrFindEntryForAddress( const void *addr, PLDR_DATA_TABLE_ENTRY *pmod )
 {
-    PLIST_ENTRY mark, entry;
-    PLDR_DATA_TABLE_ENTRY mod;
+    LDR_DATA_TABLE_ENTRY *mod;
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InMemoryOrderModuleList;
-    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
-    {
-        mod = CONTAINING_RECORD(entry, LDR_DATA_TABLE_ENTRY, InMemoryOrderLinks);
-        if (mod->DllBase <= addr &&
-            (const char *)addr < (char*)mod->DllBase + mod->SizeOfImage)
-        {
-            *pmod = mod;
-            return STATUS_SUCCESS;
-        }
-    }
-    return STATUS_NO_MORE_ENTRIES;
+    if (!(mod = find_module_range_entry( addr ))) return STATUS_NO_MORE_ENTRIES;
+    *pmod = mod;
+    return STATUS_SUCCESS;
 }
 
 /******************************************************************
@@ -2231,11 +2528,14 @@ static NTSTATUS build_module( LPCWSTR load_path, const UNICODE_STRING *nt_name,
     WINE_MODREF *wm;
     NTSTATUS status;
     SIZE_T map_size;
+    LONGLONG start;
 
     if (!(nt = RtlImageNtHeader( *module ))) return STATUS_INVALID_IMAGE_FORMAT;
 
     map_size = (nt->OptionalHeader.SizeOfImage + page_size - 1) & ~(page_size - 1);
+    start = startup_trace_start();
     if ((status = perform_relocations( *module, nt, map_size ))) return status;
+    if ((ULONG_PTR)*module != nt->OptionalHeader.ImageBase) startup_trace( "relocate", nt_name->Buffer, start );
 
     is_builtin = ((char *)nt - signature >= sizeof(builtin_signature) &&
                   !memcmp( signature, builtin_signature, sizeof(builtin_signature) ));
@@ -2244,7 +2544,7 @@ static NTSTATUS build_module( LPCWSTR load_path, const UNICODE_STRING *nt_name,
 
     if (!(wm = alloc_module( *module, nt_name, is_builtin ))) return STATUS_NO_MEMORY;
 
-    if (id) wm->id = *id;
+    if (id) set_module_file_id( wm, id );
     if (image_info->LoaderFlags) wm->ldr.Flags |= LDR_COR_IMAGE;
     if (image_info->u.s.ComPlusILOnly) wm->ldr.Flags |= LDR_COR_ILONLY;
     wm->system = system;
@@ -2267,6 +2567,11 @@ static NTSTATUS build_module( LPCWSTR load_path, const UNICODE_STRING *nt_name,
             /* the module has only be inserted in the load & memory order lists */
             RemoveEntryList(&wm->ldr.InLoadOrderLinks);
             RemoveEntryList(&wm->ldr.InMemoryOrderLinks);
+            remove_module_range( &wm->ldr );
+            remove_module_hash( wm );
+#if defined(__x86_64__) || defined(__arm__) || defined(__aarch64__)
+            flush_function_cache();
+#endif
 
             /* FIXME: there are several more dangling references
              * left. Including dlls loaded by this dll before the
@@ -3231,6 +3536,7 @@ static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD fl
     SECTION_IMAGE_INFORMATION image_info;
     NTSTATUS nts = STATUS_DLL_NOT_FOUND;
     ULONG64 prev;
+    LONGLONG start = startup_trace_start();
 
     TRACE( "looking for %s in %s\n", debugstr_w(libname), debugstr_w(load_path) );
 
@@ -3284,6 +3590,7 @@ static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD fl
         NtCurrentTeb()->Tib.ArbitraryUserPointer = (void *)(ULONG_PTR)prev;
 
 done:
+    startup_trace( "load_dll", libname, start );
     if (nts == STATUS_SUCCESS)
         TRACE("Loaded module %s at %p\n", debugstr_us(&nt_name), (*pwm)->ldr.DllBase);
     else
@@ -3815,21 +4122,24 @@ void WINAPI LdrShutdownThread(void)
     RtlEnterCriticalSection( &loader_section );
     wm = get_modref( NtCurrentTeb()->Peb->ImageBaseAddress );
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InInitializationOrderModuleList;
-    for (entry = mark->Blink; entry != mark; entry = entry->Blink)
+    if (!(NtCurrentTeb()->SameTebFlags & SAME_TEB_FLAGS_SKIP_THREAD_ATTACH))
     {
-        mod = CONTAINING_RECORD(entry, LDR_DATA_TABLE_ENTRY,
-                                InInitializationOrderLinks);
-        if ( !(mod->Flags & LDR_PROCESS_ATTACHED) )
-            continue;
-        if ( mod->Flags & LDR_NO_DLL_CALLS )
-            continue;
+        mark = &NtCurrentTeb()->Peb->LdrData->InInitializationOrderModuleList;
+        for (entry = mark->Blink; entry != mark; entry = entry->Blink)
+        {
+            mod = CONTAINING_RECORD(entry, LDR_DATA_TABLE_ENTRY,
+                                    InInitializationOrderLinks);
+            if ( !(mod->Flags & LDR_PROCESS_ATTACHED) )
+                continue;
+            if ( mod->Flags & LDR_NO_DLL_CALLS )
+                continue;
 
-        MODULE_InitDLL( CONTAINING_RECORD(mod, WINE_MODREF, ldr), 
-                        DLL_THREAD_DETACH, NULL );
-    }
+            MODULE_InitDLL( CONTAINING_RECORD(mod, WINE_MODREF, ldr),
+                            DLL_THREAD_DETACH, NULL );
+        }
 
-    if (wm->ldr.TlsIndex != -1) call_tls_callbacks( wm->ldr.DllBase, DLL_THREAD_DETACH );
+        if (wm->ldr.TlsIndex != -1) call_tls_callbacks( wm->ldr.DllBase, DLL_THREAD_DETACH );
+    }
 
     RtlAcquirePebLock();
     if (NtCurrentTeb()->TlsLinks.Flink) RemoveEntryList( &NtCurrentTeb()->TlsLinks );
@@ -3862,6 +4172,11 @@ static void free_modref( WINE_MODREF *wm )
 
     RemoveEntryList(&wm->ldr.InLoadOrderLinks);
     RemoveEntryList(&wm->ldr.InMemoryOrderLinks);
+    remove_module_range( &wm->ldr );
+    remove_module_hash( wm );
+#if defined(__x86_64__) || defined(__arm__) || defined(__aarch64__)
+    flush_function_cache();  /* before the unmap, so that no unwinder finds the module's tables */
+#endif
     if (wm->ldr.InInitializationOrderLinks.Flink)
         RemoveEntryList(&wm->ldr.InInitializationOrderLinks);
 
@@ -4227,6 +4542,7 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
         ANSI_STRING func_name;
         WINE_MODREF *kernel32;
         PEB *peb = NtCurrentTeb()->Peb;
+        LONGLONG start = startup_trace_start();
 
         peb->LdrData            = &ldr;
         peb->FastPebLock        = &peb_lock;
@@ -4246,6 +4562,7 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
 
         get_env_var( L"WINESYSTEMDLLPATH", 0, &system_dll_path );
 
+        init_module_hash();
         wm = build_main_module();
         wm->ldr.LoadCount = -1;
 
@@ -4283,6 +4600,7 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
             NtTerminateProcess( GetCurrentProcess(), status );
         }
         imports_fixup_done = TRUE;
+        startup_trace( "load_imports", NULL, start );
     }
     else wm = get_modref( NtCurrentTeb()->Peb->ImageBaseAddress );
 
@@ -4298,6 +4616,8 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
 
     if (!attach_done)  /* first time around */
     {
+        LONGLONG start = startup_trace_start();
+
         attach_done = 1;
         if ((status = alloc_thread_tls()) != STATUS_SUCCESS)
         {
@@ -4330,14 +4650,20 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
         if (wm->ldr.TlsIndex != -1) call_tls_callbacks( wm->ldr.DllBase, DLL_PROCESS_ATTACH );
         if (wm->ldr.Flags & LDR_WINE_INTERNAL) unix_funcs->init_builtin_dll( wm->ldr.DllBase );
         if (wm->ldr.ActivationContext) RtlDeactivateActivationContext( 0, cookie );
+        startup_trace( "process_attach", NULL, start );
         process_breakpoint();
     }
     else
     {
+        BOOL skip_attach = NtCurrentTeb()->SameTebFlags & SAME_TEB_FLAGS_SKIP_THREAD_ATTACH;
+
         if ((status = alloc_thread_tls()) != STATUS_SUCCESS)
             NtTerminateThread( GetCurrentThread(), status );
-        thread_attach();
-        if (wm->ldr.TlsIndex != -1) call_tls_callbacks( wm->ldr.DllBase, DLL_THREAD_ATTACH );
+        if (!skip_attach)
+        {
+            thread_attach();
+            if (wm->ldr.TlsIndex != -1) call_tls_callbacks( wm->ldr.DllBase, DLL_THREAD_ATTACH );
+        }
     }
 
     RtlLeaveCriticalSection( &loader_section );
@@ -4427,12 +4753,14 @@ PVOID WINAPI RtlImageRvaToVa( const IMAGE_NT_HEADERS *nt, HMODULE module,
  */
 PVOID WINAPI RtlPcToFileHeader( PVOID pc, PVOID *address )
 {
-    LDR_DATA_TABLE_ENTRY *module;
     PVOID ret = NULL;
+    unsigned int pos;
 
-    RtlEnterCriticalSection( &loader_section );
-    if (!LdrFindEntryForAddress( pc, &module )) ret = module->DllBase;
-    RtlLeaveCriticalSection( &loader_section );
+    RtlAcquireSRWLockShared( &module_ranges_lock );
+    pos = find_module_range( (ULONG_PTR)pc );
+    if (pos < module_range_count && module_ranges[pos].start <= (ULONG_PTR)pc)
+        ret = (void *)module_ranges[pos].start;
+    RtlReleaseSRWLockShared( &module_ranges_lock );
     *address = ret;
     return ret;
 }
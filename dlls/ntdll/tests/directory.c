@@ -1013,6 +1013,69 @@ static void test_redirection(void)
     pRtlWow64EnableFsRedirectionEx( old, &cur );
 }
 
+static void test_deleted_entries(void)
+{
+    char temp_path[MAX_PATH], testdir[MAX_PATH], name[MAX_PATH];
+    WCHAR testdirW[MAX_PATH];
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING ntdirname;
+    IO_STATUS_BLOCK io;
+    BYTE data[1024];
+    FILE_NAMES_INFORMATION *info = (FILE_NAMES_INFORMATION *)data;
+    NTSTATUS status;
+    HANDLE handle;
+    int i, count;
+    BOOL ret;
+
+    GetTempPathA( MAX_PATH, temp_path );
+    sprintf( testdir, "%sdeletedtest", temp_path );
+    ret = CreateDirectoryA( testdir, NULL );
+    ok( ret, "CreateDirectoryA failed err %u\n", GetLastError() );
+    for (i = 0; i < 5; i++)
+    {
+        sprintf( name, "%s\\file%d", testdir, i );
+        CloseHandle( CreateFileA( name, GENERIC_WRITE, 0, NULL, CREATE_NEW, 0, 0 ));
+    }
+
+    MultiByteToWideChar( CP_ACP, 0, testdir, -1, testdirW, MAX_PATH );
+    if (!pRtlDosPathNameToNtPathName_U( testdirW, &ntdirname, NULL, NULL ))
+    {
+        ok(0, "RtlDosPathNametoNtPathName_U failed\n");
+        return;
+    }
+    InitializeObjectAttributes( &attr, &ntdirname, OBJ_CASE_INSENSITIVE, 0, NULL );
+    status = pNtOpenFile( &handle, SYNCHRONIZE | FILE_LIST_DIRECTORY, &attr, &io, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                          FILE_SYNCHRONOUS_IO_NONALERT | FILE_OPEN_FOR_BACKUP_INTENT | FILE_DIRECTORY_FILE );
+    ok( status == STATUS_SUCCESS, "failed to open dir %s\n", testdir );
+
+    status = pNtQueryDirectoryFile( handle, NULL, NULL, NULL, &io, data, sizeof(data),
+                                    FileNamesInformation, TRUE, NULL, TRUE );
+    ok( status == STATUS_SUCCESS, "failed to query directory; status %x\n", status );
+
+    /* files deleted after the listing has started must not be returned */
+    for (i = 0; i < 5; i++)
+    {
+        sprintf( name, "%s\\file%d", testdir, i );
+        ret = DeleteFileA( name );
+        ok( ret, "DeleteFileA failed err %u\n", GetLastError() );
+    }
+
+    for (count = 0; count < 10; count++)
+    {
+        status = pNtQueryDirectoryFile( handle, NULL, NULL, NULL, &io, data, sizeof(data),
+                                        FileNamesInformation, TRUE, NULL, FALSE );
+        if (status == STATUS_NO_MORE_FILES) break;
+        ok( status == STATUS_SUCCESS, "failed to query directory; status %x\n", status );
+        ok( info->FileNameLength == 4 && !memcmp( info->FileName, L"..", 4 ), "got entry %s\n",
+            wine_dbgstr_wn( info->FileName, info->FileNameLength / sizeof(WCHAR) ));
+    }
+    ok( count == 1, "got %d entries\n", count );
+
+    pNtClose( handle );
+    pRtlFreeUnicodeString( &ntdirname );
+    RemoveDirectoryA( testdir );
+}
+
 START_TEST(directory)
 {
     WCHAR sysdir[MAX_PATH];
@@ -1037,4 +1100,5 @@ START_TEST(directory)
     test_NtQueryDirectoryFile();
     test_NtQueryDirectoryFile_case();
     test_redirection();
+    test_deleted_entries();
 }
@@ -2567,7 +2567,8 @@ static void test_dynamic_unwind(void)
 {
     static const int code_offset = 1024;
     char buf[2 * sizeof(RUNTIME_FUNCTION) + 4];
-    RUNTIME_FUNCTION *runtime_func, *func;
+    RUNTIME_FUNCTION *runtime_func, *func, history_func;
+    UNWIND_HISTORY_TABLE history;
     ULONG_PTR table, base;
     void *growable_table;
     NTSTATUS status;
@@ -2597,6 +2598,34 @@ static void test_dynamic_unwind(void)
     ok( base == (ULONG_PTR)code_mem,
         "RtlLookupFunctionEntry returned invalid base, expected: %lx, got: %lx\n", (ULONG_PTR)code_mem, base );
 
+    /* Test with an unwind history table */
+    memset( &history, 0, sizeof(history) );
+    history.Search = UNWIND_HISTORY_TABLE_NONE;
+    history.LowAddress = ~(ULONG64)0;
+    base = 0xdeadbeef;
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + code_offset + 8, &base, &history );
+    ok( func == runtime_func,
+        "RtlLookupFunctionEntry didn't return expected function, expected: %p, got: %p\n", runtime_func, func );
+    ok( base == (ULONG_PTR)code_mem,
+        "RtlLookupFunctionEntry returned invalid base, expected: %lx, got: %lx\n", (ULONG_PTR)code_mem, base );
+    ok( history.Count == 1, "got history count %u\n", history.Count );
+    ok( history.Entry[0].FunctionEntry == runtime_func, "got function entry %p\n", history.Entry[0].FunctionEntry );
+    ok( history.Entry[0].ImageBase == (ULONG_PTR)code_mem, "got image base %I64x\n", history.Entry[0].ImageBase );
+    ok( history.LowAddress == (ULONG_PTR)code_mem + code_offset, "got low address %I64x\n", history.LowAddress );
+    ok( history.HighAddress == (ULONG_PTR)code_mem + code_offset + 16, "got high address %I64x\n", history.HighAddress );
+
+    /* a search returns the entry recorded in the table instead of looking up the function again */
+    history.Entry[0].FunctionEntry = &history_func;
+    history_func = *runtime_func;
+    history.Search = UNWIND_HISTORY_TABLE_GLOBAL;
+    base = 0xdeadbeef;
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + code_offset + 4, &base, &history );
+    ok( func == &history_func,
+        "RtlLookupFunctionEntry didn't return expected function, expected: %p, got: %p\n", &history_func, func );
+    ok( base == (ULONG_PTR)code_mem,
+        "RtlLookupFunctionEntry returned invalid base, expected: %lx, got: %lx\n", (ULONG_PTR)code_mem, base );
+    ok( history.Count == 1, "got history count %u\n", history.Count );
+
     /* Test RtlDeleteFunctionTable */
     ok( pRtlDeleteFunctionTable( runtime_func ),
         "RtlDeleteFunctionTable failed for runtime_func = %p (aligned)\n", runtime_func );
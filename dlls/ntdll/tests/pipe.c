@@ -461,6 +461,60 @@ static void test_alertable(void)
     CloseHandle(hPipe);
 }
 
+static DWORD WINAPI queue_userapc_thread(void *main_thread)
+{
+    DWORD ret;
+
+    Sleep(200);
+    ret = pQueueUserAPC(&userapc, main_thread, 0);
+    ok(ret, "can't queue user apc, GetLastError: %x\n", GetLastError());
+    CloseHandle(main_thread);
+    return 0;
+}
+
+static void test_alertable_read(void)
+{
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING name;
+    IO_STATUS_BLOCK io;
+    HANDLE pipe, client, thread;
+    LARGE_INTEGER timeout;
+    NTSTATUS status;
+    char buf[16];
+
+    pRtlInitUnicodeString(&name, testpipe_nt);
+    attr.Length                   = sizeof(attr);
+    attr.RootDirectory            = 0;
+    attr.ObjectName               = &name;
+    attr.Attributes               = OBJ_CASE_INSENSITIVE;
+    attr.SecurityDescriptor       = NULL;
+    attr.SecurityQualityOfService = NULL;
+
+    timeout.QuadPart = -100000000;
+    status = pNtCreateNamedPipeFile(&pipe, SYNCHRONIZE | GENERIC_READ | GENERIC_WRITE, &attr, &io,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE, FILE_CREATE, FILE_SYNCHRONOUS_IO_ALERT,
+                                    0, 0, 0, 1, 4096, 4096, &timeout);
+    ok(status == STATUS_SUCCESS, "NtCreateNamedPipeFile returned %x\n", status);
+
+    status = NtCreateFile(&client, SYNCHRONIZE | GENERIC_READ | GENERIC_WRITE, &attr, &io,
+                          NULL, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, FILE_OPEN,
+                          FILE_SYNCHRONOUS_IO_ALERT, NULL, 0 );
+    ok(status == STATUS_SUCCESS, "NtCreateFile returned %x\n", status);
+
+    /* a user APC interrupts a blocking read on an alertable byte mode pipe */
+    userapc_called = FALSE;
+    thread = CreateThread(NULL, 0, queue_userapc_thread,
+                          pOpenThread(THREAD_ALL_ACCESS, FALSE, GetCurrentThreadId()), 0, NULL);
+    status = NtReadFile(client, NULL, NULL, NULL, &io, buf, sizeof(buf), NULL, NULL);
+    ok(status == STATUS_USER_APC, "status = %x\n", status);
+    ok(userapc_called, "user apc didn't run\n");
+
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+    CloseHandle(client);
+    CloseHandle(pipe);
+}
+
 static void test_nonalertable(void)
 {
     IO_STATUS_BLOCK iosb;
@@ -2600,6 +2654,9 @@ START_TEST(pipe)
     trace("starting alertable tests\n");
     test_alertable();
 
+    trace("starting alertable read tests\n");
+    test_alertable_read();
+
     trace("starting nonalertable tests\n");
     test_nonalertable();
 
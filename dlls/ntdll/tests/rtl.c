@@ -3210,6 +3210,50 @@ static void test_LdrEnumerateLoadedModules(void)
     ok(status == STATUS_INVALID_PARAMETER, "expected STATUS_INVALID_PARAMETER, got 0x%08x\n", status);
 }
 
+static void test_LdrFindEntryForAddress(void)
+{
+    LDR_DATA_TABLE_ENTRY *entry;
+    NTSTATUS status;
+    char *base;
+    void *ret, *addr;
+    ULONG size;
+
+    status = LdrFindEntryForAddress( (char *)RtlPcToFileHeader + 1, &entry );
+    ok(!status, "LdrFindEntryForAddress failed with %08x\n", status);
+    if (status) return;
+    ok(entry->DllBase == hntdll, "got base %p, expected %p\n", entry->DllBase, hntdll);
+    ok(!lstrcmpiW(entry->BaseDllName.Buffer, L"ntdll.dll"), "got name %s\n", wine_dbgstr_w(entry->BaseDllName.Buffer));
+
+    base = entry->DllBase;
+    size = entry->SizeOfImage;
+    entry = NULL;
+    status = LdrFindEntryForAddress( base + size - 1, &entry );
+    ok(!status, "LdrFindEntryForAddress failed with %08x\n", status);
+    ok(entry && entry->DllBase == base, "got entry %p\n", entry);
+
+    entry = NULL;
+    status = LdrFindEntryForAddress( base + size, &entry );
+    ok(status || entry->DllBase != base, "found the end of ntdll in %p\n", entry);
+
+    entry = (void *)0xdeadbeef;
+    status = LdrFindEntryForAddress( NULL, &entry );
+    ok(status == STATUS_NO_MORE_ENTRIES, "got %08x\n", status);
+    ok(entry == (void *)0xdeadbeef, "got entry %p\n", entry);
+
+    addr = (void *)0xdeadbeef;
+    ret = RtlPcToFileHeader( (char *)RtlPcToFileHeader + 1, &addr );
+    ok(ret == hntdll, "got %p, expected %p\n", ret, hntdll);
+    ok(addr == hntdll, "got %p, expected %p\n", addr, hntdll);
+
+    addr = (void *)0xdeadbeef;
+    ret = RtlPcToFileHeader( NULL, &addr );
+    ok(!ret, "got %p\n", ret);
+    ok(!addr, "got %p\n", addr);
+
+    ret = RtlPcToFileHeader( (char *)GetModuleHandleA( NULL ) + 1, &addr );
+    ok(ret == GetModuleHandleA( NULL ), "got %p, expected %p\n", ret, GetModuleHandleA( NULL ));
+}
+
 static void test_RtlMakeSelfRelativeSD(void)
 {
     char buf[sizeof(SECURITY_DESCRIPTOR_RELATIVE) + 4];
@@ -3721,6 +3765,7 @@ START_TEST(rtl)
     test_RtlInitializeCriticalSectionEx();
     test_RtlLeaveCriticalSection();
     test_LdrEnumerateLoadedModules();
+    test_LdrFindEntryForAddress();
     test_RtlMakeSelfRelativeSD();
     test_LdrRegisterDllNotification();
     test_DbgPrint();
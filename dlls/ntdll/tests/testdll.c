@@ -0,0 +1,44 @@
+/*
+ * Helper DLL for the ntdll thread tests
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include <stdarg.h>
+
+#include "windef.h"
+#include "winbase.h"
+
+static LONG thread_attach_count, thread_detach_count;
+
+void WINAPI get_thread_counts( LONG *attach, LONG *detach )
+{
+    *attach = thread_attach_count;
+    *detach = thread_detach_count;
+}
+
+BOOL WINAPI DllMain( HINSTANCE instance, DWORD reason, void *reserved )
+{
+    switch (reason)
+    {
+    case DLL_THREAD_ATTACH:
+        InterlockedIncrement( &thread_attach_count );
+        break;
+    case DLL_THREAD_DETACH:
+        InterlockedIncrement( &thread_detach_count );
+        break;
+    }
+    return TRUE;
+}
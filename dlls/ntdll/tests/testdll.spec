@@ -0,0 +1 @@
+@ stdcall get_thread_counts(ptr ptr)
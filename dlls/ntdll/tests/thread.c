@@ -118,9 +118,113 @@ static void test_dbg_hidden_thread_creation(void)
     CloseHandle( thread );
 }
 
+static void CALLBACK test_skip_thread_attach_proc(void *param)
+{
+    *(USHORT *)param = NtCurrentTeb()->SameTebFlags;
+}
+
+static void test_skip_thread_attach(void)
+{
+    USHORT flags;
+    HANDLE thread;
+    NTSTATUS status;
+
+    if (!pNtCreateThreadEx)
+    {
+        win_skip( "NtCreateThreadEx is not available.\n" );
+        return;
+    }
+
+    flags = 0xffff;
+    status = pNtCreateThreadEx( &thread, THREAD_ALL_ACCESS, NULL, GetCurrentProcess(), test_skip_thread_attach_proc,
+                                &flags, 0, 0, 0, 0, NULL );
+    ok( status == STATUS_SUCCESS, "Got unexpected status %#x.\n", status );
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+    ok( !(flags & SAME_TEB_FLAGS_SKIP_THREAD_ATTACH), "Got unexpected flags %#x.\n", flags );
+
+    flags = 0;
+    status = pNtCreateThreadEx( &thread, THREAD_ALL_ACCESS, NULL, GetCurrentProcess(), test_skip_thread_attach_proc,
+                                &flags, THREAD_CREATE_FLAGS_SKIP_THREAD_ATTACH, 0, 0, 0, NULL );
+    ok( status == STATUS_SUCCESS, "Got unexpected status %#x.\n", status );
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+    ok( flags & SAME_TEB_FLAGS_SKIP_THREAD_ATTACH, "Got unexpected flags %#x.\n", flags );
+}
+
+static char *load_resource( const char *name )
+{
+    static char path[MAX_PATH];
+    DWORD written;
+    HANDLE file;
+    HRSRC res;
+    void *ptr;
+
+    GetTempPathA( ARRAY_SIZE(path), path );
+    strcat( path, name );
+
+    file = CreateFileA( path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, 0 );
+    ok( file != INVALID_HANDLE_VALUE, "Failed to create file %s: %u.\n", debugstr_a(path), GetLastError() );
+
+    res = FindResourceA( NULL, name, "TESTDLL" );
+    ok( !!res, "Failed to load resource: %u.\n", GetLastError() );
+    ptr = LockResource( LoadResource( GetModuleHandleA( NULL ), res ));
+    WriteFile( file, ptr, SizeofResource( GetModuleHandleA( NULL ), res ), &written, NULL );
+    ok( written == SizeofResource( GetModuleHandleA( NULL ), res ), "Failed to write resource.\n" );
+    CloseHandle( file );
+
+    return path;
+}
+
+static void test_skip_thread_attach_notifications(void)
+{
+    void (WINAPI *pget_thread_counts)( LONG *, LONG * );
+    LONG attach, detach;
+    HANDLE thread;
+    NTSTATUS status;
+    HMODULE module;
+    USHORT flags;
+    char *path;
+
+    if (!pNtCreateThreadEx)
+    {
+        win_skip( "NtCreateThreadEx is not available.\n" );
+        return;
+    }
+
+    path = load_resource( "testdll.dll" );
+    module = LoadLibraryA( path );
+    ok( !!module, "Failed to load %s: %u.\n", debugstr_a(path), GetLastError() );
+    pget_thread_counts = (void *)GetProcAddress( module, "get_thread_counts" );
+
+    status = pNtCreateThreadEx( &thread, THREAD_ALL_ACCESS, NULL, GetCurrentProcess(), test_skip_thread_attach_proc,
+                                &flags, 0, 0, 0, 0, NULL );
+    ok( status == STATUS_SUCCESS, "Got unexpected status %#x.\n", status );
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+    pget_thread_counts( &attach, &detach );
+    ok( attach == 1, "Got unexpected attach count %d.\n", attach );
+    ok( detach == 1, "Got unexpected detach count %d.\n", detach );
+
+    /* the notifications of the DLL are skipped for the whole lifetime of the thread */
+    status = pNtCreateThreadEx( &thread, THREAD_ALL_ACCESS, NULL, GetCurrentProcess(), test_skip_thread_attach_proc,
+                                &flags, THREAD_CREATE_FLAGS_SKIP_THREAD_ATTACH, 0, 0, 0, NULL );
+    ok( status == STATUS_SUCCESS, "Got unexpected status %#x.\n", status );
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+    pget_thread_counts( &attach, &detach );
+    ok( attach == 1, "Got unexpected attach count %d.\n", attach );
+    ok( detach == 1, "Got unexpected detach count %d.\n", detach );
+
+    FreeLibrary( module );
+    DeleteFileA( path );
+}
+
 START_TEST(thread)
 {
     init_function_pointers();
 
     test_dbg_hidden_thread_creation();
+    test_skip_thread_attach();
+    test_skip_thread_attach_notifications();
 }
@@ -33,6 +33,7 @@
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #include "ntstatus.h"
@@ -53,12 +54,55 @@ struct debug_info
 {
     unsigned int str_pos;       /* current position in strings buffer */
     unsigned int out_pos;       /* current position in output buffer */
-    char         strings[1020]; /* buffer for temporary strings */
+    unsigned int trace_line;    /* current line goes to the binary trace file */
+    unsigned int trace_chunk;   /* current chunk in the binary trace file, plus one */
+    unsigned int trace_seq;     /* sequence number of the current chunk */
+    unsigned int trace_pos;     /* current position in the chunk */
+    char         strings[1004]; /* buffer for temporary strings */
     char         output [1020]; /* current output line */
 };
 
 C_ASSERT( sizeof(struct debug_info) == 0x800 );
 
+/* binary trace file, enabled by setting WINEDEBUGTRACE to a file name prefix; trace and warn
+ * lines are stored there by each thread in its own chunk and can be converted back to text
+ * with tools/decode-debug-trace */
+
+#define DEBUG_TRACE_MAGIC       "WINEDBGT"
+#define DEBUG_TRACE_VERSION     1
+#define DEBUG_TRACE_HEADER_SIZE 0x1000
+#define DEBUG_TRACE_CHUNK_SIZE  0x10000
+#define DEBUG_TRACE_CHUNKS      1024  /* chunks are reused in a ring once they are all claimed */
+#define DEBUG_TRACE_CHUNK_BUSY  0x80000000  /* set in the chunk sequence number while it's being written */
+
+struct debug_trace_header
+{
+    char      magic[8];      /* DEBUG_TRACE_MAGIC */
+    UINT      version;       /* DEBUG_TRACE_VERSION */
+    UINT      chunk_size;    /* size of each chunk */
+    UINT      chunk_count;   /* number of chunks following the header */
+    LONG      next_seq;      /* sequence number of the next chunk to claim */
+    ULONGLONG freq;          /* frequency of the record timestamps */
+};
+
+struct debug_trace_chunk
+{
+    UINT      tid;           /* thread owning the chunk */
+    LONG      seq;           /* sequence number of the chunk, the chunk index is seq % chunk_count */
+    UINT      used;          /* bytes used in the chunk, including this header */
+    UINT      reserved;
+};
+
+struct debug_trace_record
+{
+    UINT      len;           /* length of the text */
+    UINT      reserved;
+    ULONGLONG time;          /* performance counter value */
+    /* followed by the text, padded to 8 bytes */
+};
+
+static struct debug_trace_header * HOSTPTR debug_trace;
+
 static BOOL init_done;
 static struct debug_info initial_info;  /* debug info for initial thread */
 static unsigned char default_flags = (1 << __WINE_DBCL_ERR) | (1 << __WINE_DBCL_FIXME);
@@ -214,6 +258,116 @@ static void init_options(void)
     parse_options( wine_debug );
 }
 
+static inline struct debug_trace_chunk * HOSTPTR debug_trace_chunk( unsigned int index )
+{
+    return (struct debug_trace_chunk * HOSTPTR)((char * HOSTPTR)debug_trace + DEBUG_TRACE_HEADER_SIZE +
+                                                (size_t)index * DEBUG_TRACE_CHUNK_SIZE);
+}
+
+/* lock the chunk of the current thread for writing, claiming a new one if there are less than size
+ * bytes available; the lock is released by storing the sequence number back without the busy flag */
+static struct debug_trace_chunk * HOSTPTR lock_debug_trace_chunk( struct debug_info *info, UINT size )
+{
+    struct debug_trace_chunk * HOSTPTR chunk;
+    LONG seq, prev;
+
+    /* this fails if the chunk has been reused by another thread after the ring wrapped around */
+    if (info->trace_chunk && info->trace_pos + size <= DEBUG_TRACE_CHUNK_SIZE)
+    {
+        chunk = debug_trace_chunk( info->trace_chunk - 1 );
+        if (InterlockedCompareExchange( &chunk->seq, info->trace_seq | DEBUG_TRACE_CHUNK_BUSY,
+                                        info->trace_seq ) == info->trace_seq)
+            return chunk;
+    }
+
+    for (;;)
+    {
+        seq = (InterlockedIncrement( &debug_trace->next_seq ) - 1) & ~DEBUG_TRACE_CHUNK_BUSY;
+        chunk = debug_trace_chunk( seq % DEBUG_TRACE_CHUNKS );
+        prev = chunk->seq;
+        /* don't wait for a chunk that is being written, possibly by ourselves from a signal
+         * handler, and don't take over one that a later claim already got; try the next one */
+        if (prev & DEBUG_TRACE_CHUNK_BUSY || prev > seq) continue;
+        if (InterlockedCompareExchange( &chunk->seq, seq | DEBUG_TRACE_CHUNK_BUSY, prev ) == prev) break;
+    }
+
+    info->trace_seq = seq;
+    info->trace_chunk = seq % DEBUG_TRACE_CHUNKS + 1;
+    info->trace_pos = sizeof(*chunk);
+    chunk->tid = init_done ? GetCurrentThreadId() : 0;
+    __atomic_store_n( &chunk->used, info->trace_pos, __ATOMIC_RELEASE );
+    return chunk;
+}
+
+/* store the current output line in the binary trace file */
+static void write_debug_trace( struct debug_info *info )
+{
+    struct debug_trace_chunk * HOSTPTR chunk;
+    struct debug_trace_record * HOSTPTR record;
+    UINT len = info->out_pos;
+    UINT size = sizeof(*record) + ((len + 7) & ~7);
+    LARGE_INTEGER counter;
+
+    NtQueryPerformanceCounter( &counter, NULL );
+    chunk = lock_debug_trace_chunk( info, size );
+    record = (struct debug_trace_record * HOSTPTR)((char * HOSTPTR)chunk + info->trace_pos);
+    record->len = len;
+    record->reserved = 0;
+    record->time = counter.QuadPart;
+    memcpy( record + 1, info->output, len );
+    info->trace_pos += size;
+    /* make the record visible to the decoder only once it's complete */
+    __atomic_store_n( &chunk->used, info->trace_pos, __ATOMIC_RELEASE );
+    __atomic_store_n( &chunk->seq, info->trace_seq, __ATOMIC_RELEASE );
+}
+
+/* create the binary trace file if requested */
+static void init_debug_trace(void)
+{
+    const char * HOSTPTR prefix = getenv( "WINEDEBUGTRACE" );
+    size_t size = DEBUG_TRACE_HEADER_SIZE + (size_t)DEBUG_TRACE_CHUNKS * DEBUG_TRACE_CHUNK_SIZE;
+    struct debug_trace_header * HOSTPTR header;
+    LARGE_INTEGER counter, freq;
+    char * HOSTPTR path;
+    int fd;
+
+    if (!prefix || !prefix[0]) return;
+    if (!(path = malloc( strlen( prefix ) + 32 ))) return;
+    sprintf( path, "%s-%d.trace", prefix, (int)getpid() );
+    fd = open( path, O_RDWR | O_CREAT | O_TRUNC, 0666 );
+    free( path );
+    if (fd == -1) return;
+    fcntl( fd, F_SETFD, FD_CLOEXEC );
+
+    if (!ftruncate( fd, size ) &&
+        (header = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) != MAP_FAILED)
+    {
+        NtQueryPerformanceCounter( &counter, &freq );
+        header->version     = DEBUG_TRACE_VERSION;
+        header->chunk_size  = DEBUG_TRACE_CHUNK_SIZE;
+        header->chunk_count = DEBUG_TRACE_CHUNKS;
+        header->next_seq    = 0;
+        header->freq        = freq.QuadPart;
+        memcpy( header->magic, DEBUG_TRACE_MAGIC, sizeof(header->magic) );
+        debug_trace = header;
+    }
+    close( fd );
+}
+
+/***********************************************************************
+ *		dbg_reset_trace
+ *
+ * Drop the binary trace file inherited from the parent in a process forked without exec;
+ * dbg_init() creates the file of the new process.
+ */
+void dbg_reset_trace(void)
+{
+    if (!debug_trace) return;
+    munmap( debug_trace, DEBUG_TRACE_HEADER_SIZE + (size_t)DEBUG_TRACE_CHUNKS * DEBUG_TRACE_CHUNK_SIZE );
+    debug_trace = NULL;
+    initial_info.trace_line = initial_info.trace_chunk = initial_info.trace_seq = initial_info.trace_pos = 0;
+}
+
 /***********************************************************************
  *		__wine_dbg_get_channel_flags  (NTDLL.@)
  *
@@ -294,8 +448,10 @@ int __cdecl __wine_dbg_output( const char *str )
     if (end)
     {
         ret += append_output( info, str, end + 1 - str );
-        write( 2, info->output, info->out_pos );
+        if (info->trace_line) write_debug_trace( info );
+        else write( 2, info->output, info->out_pos );
         info->out_pos = 0;
+        info->trace_line = 0;
         str = end + 1;
     }
     if (*str) ret += append_output( info, str, strlen( str ));
@@ -328,7 +484,10 @@ int __cdecl __wine_dbg_header( enum __wine_debug_class cls, struct __wine_debug_
     /* only print header if we are at the beginning of the line */
     if (info->out_pos) return 0;
 
-    if (init_done)
+    /* the time and thread of trace lines are stored in the trace file */
+    info->trace_line = debug_trace && (cls == __WINE_DBCL_TRACE || cls == __WINE_DBCL_WARN);
+
+    if (init_done && !info->trace_line)
     {
         if (TRACE_ON(timestamp))
         {
@@ -356,6 +515,7 @@ void dbg_init(void)
     setbuf( stderr, NULL );
 
     if (nb_debug_options == -1) init_options();
+    init_debug_trace();
 
     options = ADDRSPACECAST(struct __wine_debug_channel *, ((char *)peb + (is_win64 ? 2 : 1) * page_size));
     memcpy( options, debug_options, nb_debug_options * sizeof(*options) );
@@ -387,3 +547,113 @@ NTSTATUS WINAPI NtSetDebugFilterState( ULONG component_id, ULONG level, BOOLEAN
 
     return STATUS_SUCCESS;
 }
+
+
+/* startup trace, enabled by setting WINESTARTUPTRACE to a file name prefix */
+
+#define MAX_STARTUP_TRACE_EVENTS 4096
+
+struct startup_trace_event
+{
+    char     name[32];      /* phase name */
+    char     arg[64];       /* module name or other detail */
+    LONGLONG start;         /* start and end times in performance counter ticks */
+    LONGLONG end;
+    DWORD    tid;           /* thread id, 0 for the Unix side process setup */
+};
+
+static const char * HOSTPTR startup_trace_prefix;
+static struct startup_trace_event * HOSTPTR startup_trace_events;
+static LONG startup_trace_count;
+static LONGLONG startup_trace_freq;
+
+/***********************************************************************
+ *		startup_trace_start
+ *
+ * Return the start time of a startup phase, or 0 if the startup trace is disabled.
+ */
+LONGLONG startup_trace_start(void)
+{
+    static int enabled = -1;
+    LARGE_INTEGER counter, freq;
+
+    if (enabled == -1)
+    {
+        startup_trace_prefix = getenv( "WINESTARTUPTRACE" );
+        enabled = startup_trace_prefix && startup_trace_prefix[0] &&
+                  (startup_trace_events = calloc( MAX_STARTUP_TRACE_EVENTS, sizeof(*startup_trace_events) ));
+    }
+    if (!enabled) return 0;
+    NtQueryPerformanceCounter( &counter, &freq );
+    startup_trace_freq = freq.QuadPart;
+    return counter.QuadPart;
+}
+
+/***********************************************************************
+ *		startup_trace
+ *
+ * Record a startup phase that began at the given time and ends now.
+ */
+void CDECL startup_trace( const char *name, const WCHAR *arg, LONGLONG start, DWORD tid )
+{
+    struct startup_trace_event *event;
+    LARGE_INTEGER counter;
+    LONG index;
+    int i;
+
+    if (!start || !startup_trace_events) return;
+    NtQueryPerformanceCounter( &counter, NULL );
+    if ((index = InterlockedIncrement( &startup_trace_count ) - 1) >= MAX_STARTUP_TRACE_EVENTS) return;
+
+    event = &startup_trace_events[index];
+    snprintf( event->name, sizeof(event->name), "%s", name );
+    /* keep the JSON output simple by only storing printable ASCII */
+    for (i = 0; arg && arg[i] && i < sizeof(event->arg) - 1; i++)
+        event->arg[i] = (arg[i] >= ' ' && arg[i] < 0x7f && arg[i] != '"' && arg[i] != '\\') ? arg[i] : '?';
+    event->arg[i] = 0;
+    event->start = start;
+    event->tid = tid;
+    event->end = counter.QuadPart;
+}
+
+static inline double startup_trace_usecs( LONGLONG ticks )
+{
+    return ticks * 1000000.0 / startup_trace_freq;
+}
+
+/***********************************************************************
+ *		startup_trace_write
+ *
+ * Write the recorded startup phases to a Chrome trace event file.
+ */
+void startup_trace_write(void)
+{
+    unsigned int i, count = min( startup_trace_count, MAX_STARTUP_TRACE_EVENTS );
+    char * HOSTPTR path;
+    FILE *file;
+    int pid = getpid();
+
+    if (!startup_trace_events || !count) return;
+
+    if (!(path = malloc( strlen( startup_trace_prefix ) + 16 ))) return;
+    sprintf( path, "%s-%d.json", startup_trace_prefix, pid );
+    file = fopen( path, "w" );
+    free( path );
+    if (!file) return;
+
+    fprintf( file, "{\"traceEvents\":[\n" );
+    fprintf( file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+             "\"args\":{\"name\":\"unix setup\"}}", pid );
+    for (i = 0; i < count; i++)
+    {
+        const struct startup_trace_event *event = &startup_trace_events[i];
+
+        if (!event->end) continue;  /* still being written */
+        fprintf( file, ",\n{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"X\",\"ts\":%.1f,\"dur\":%.1f,"
+                 "\"pid\":%d,\"tid\":%u,\"args\":{\"module\":\"%s\"}}",
+                 event->name, startup_trace_usecs( event->start ),
+                 startup_trace_usecs( event->end - event->start ), pid, event->tid, event->arg );
+    }
+    fprintf( file, "\n]}\n" );
+    fclose( file );
+}
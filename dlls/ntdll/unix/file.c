@@ -42,6 +42,8 @@
 #endif
 #include <poll.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #ifdef HAVE_SYS_STATVFS_H
 # include <sys/statvfs.h>
 #endif
@@ -194,6 +196,15 @@ union file_directory_info
     FILE_NAMES_INFORMATION             names;
 };
 
+#ifdef DT_UNKNOWN
+#define DIRENT_TYPE(de) ((de)->d_type)
+#else
+#define DT_UNKNOWN 0
+#define DT_DIR     4
+#define DT_LNK     10
+#define DIRENT_TYPE(de) DT_UNKNOWN
+#endif
+
 struct dir_data_buffer
 {
     struct dir_data_buffer *next;    /* next buffer in the list */
@@ -207,6 +218,7 @@ struct dir_data_names
     const WCHAR *long_name;          /* long file name in Unicode */
     const WCHAR *short_name;         /* short file name in Unicode */
     const char  *unix_name;          /* Unix file name in host encoding */
+    unsigned char type;              /* file type from the directory entry, DT_UNKNOWN if not known */
 };
 
 struct dir_data
@@ -401,7 +413,8 @@ static const WCHAR *add_dir_data_nameW( struct dir_data *data, const WCHAR *name
 
 /* add an entry to the directory names array */
 static BOOL add_dir_data_names( struct dir_data *data, const WCHAR *long_name,
-                                const WCHAR *short_name, const char * HOSTPTR unix_name )
+                                const WCHAR *short_name, const char * HOSTPTR unix_name,
+                                unsigned char type )
 {
     static const WCHAR empty[1];
     struct dir_data_names *names = data->names;
@@ -423,6 +436,7 @@ static BOOL add_dir_data_names( struct dir_data *data, const WCHAR *long_name,
 
     if (!(names[data->count].long_name = add_dir_data_nameW( data, long_name ))) return FALSE;
     if (!(names[data->count].unix_name = add_dir_data_nameA( data, unix_name ))) return FALSE;
+    names[data->count].type = type;
     data->count++;
     return TRUE;
 }
@@ -1404,7 +1418,7 @@ static BOOLEAN is_legal_8dot3_name( const WCHAR *name, int len )
  * Add a file to the directory data if it matches the mask.
  */
 static BOOL append_entry( struct dir_data *data, const char * HOSTPTR long_name,
-                          const char * HOSTPTR short_name, const UNICODE_STRING *mask )
+                          const char * HOSTPTR short_name, const UNICODE_STRING *mask, unsigned char type )
 {
     int long_len, short_len;
     WCHAR long_nameW[MAX_DIR_ENTRY_LEN + 1];
@@ -1437,7 +1451,7 @@ static BOOL append_entry( struct dir_data *data, const char * HOSTPTR long_name,
         if (!match_filename( short_nameW, short_len, mask )) return TRUE;
     }
 
-    return add_dir_data_names( data, long_nameW, short_nameW, long_name );
+    return add_dir_data_names( data, long_nameW, short_nameW, long_name, type );
 }
 
 
@@ -1787,6 +1801,221 @@ static NTSTATUS server_get_unix_name( HANDLE handle, char * HOSTPTR * HOSTPTR un
     return ret;
 }
 
+
+/* optional per-handle cache of the file metadata returned by NtQueryInformationFile */
+
+#define FILE_INFO_CACHE_SIZE 256
+
+#define FILE_INFO_FD_STAT    0x01  /* st/attr retrieved from the fd */
+#define FILE_INFO_NAME       0x02  /* unix_name retrieved from the server */
+#define FILE_INFO_NAME_STAT  0x04  /* name_st/name_attr retrieved from unix_name */
+
+struct file_info_cache_entry
+{
+    HANDLE          handle;
+    int             fd;          /* unix fd the info was retrieved through */
+    unsigned int    options;     /* file options when the fd info was retrieved */
+    unsigned int    valid;       /* FILE_INFO_* flags */
+    LONG            generation;  /* value of file_info_generation when the entry was filled */
+    ULONG           expires;     /* tick count after which the entry is stale */
+    struct stat     st;
+    ULONG           attr;
+    struct stat     name_st;
+    ULONG           name_attr;
+    char * HOSTPTR  unix_name;
+};
+
+static struct file_info_cache_entry file_info_cache[FILE_INFO_CACHE_SIZE];
+static pthread_mutex_t file_info_mutex = PTHREAD_MUTEX_INITIALIZER;
+static LONG file_info_generation;
+
+/* returns the lifetime of the cache entries in milliseconds, 0 if the cache is disabled */
+static ULONG file_info_cache_timeout(void)
+{
+    static int timeout = -1;
+
+    if (timeout == -1)
+    {
+        const char *env = getenv( "WINEFILEINFOCACHE" );
+        timeout = env ? max( atoi( env ), 0 ) : 0;
+    }
+    return timeout;
+}
+
+/***********************************************************************
+ *           invalidate_file_info_cache
+ *
+ * Called once an operation of this process that may change file metadata is done, so that
+ * the info retrieved while it was in progress doesn't get cached.
+ */
+void invalidate_file_info_cache(void)
+{
+    if (file_info_cache_timeout()) InterlockedIncrement( &file_info_generation );
+}
+
+static struct file_info_cache_entry *file_info_cache_slot( HANDLE handle )
+{
+    return &file_info_cache[((ULONG_PTR)handle >> 2) % FILE_INFO_CACHE_SIZE];
+}
+
+static void clear_file_info_entry( struct file_info_cache_entry *entry )
+{
+    free( entry->unix_name );
+    memset( entry, 0, sizeof(*entry) );
+}
+
+/* return the entry for a handle if it holds the requested info; called with file_info_mutex held */
+static struct file_info_cache_entry *get_file_info_entry( HANDLE handle, int fd, unsigned int flag )
+{
+    struct file_info_cache_entry *entry = file_info_cache_slot( handle );
+
+    if (entry->handle != handle || entry->fd != fd || !(entry->valid & flag)) return NULL;
+    if (entry->generation != file_info_generation || (LONG)(NtGetTickCount() - entry->expires) >= 0)
+    {
+        clear_file_info_entry( entry );
+        return NULL;
+    }
+    return entry;
+}
+
+/* return an entry to store info for a handle; called with file_info_mutex held */
+static struct file_info_cache_entry *alloc_file_info_entry( HANDLE handle, int fd, LONG generation )
+{
+    struct file_info_cache_entry *entry = file_info_cache_slot( handle );
+
+    /* the metadata may have changed while we were retrieving it */
+    if (generation != file_info_generation) return NULL;
+
+    if (entry->handle != handle || entry->fd != fd || entry->generation != generation ||
+        (LONG)(NtGetTickCount() - entry->expires) >= 0)
+    {
+        clear_file_info_entry( entry );
+        entry->handle = handle;
+        entry->fd = fd;
+        entry->generation = generation;
+        entry->expires = NtGetTickCount() + file_info_cache_timeout();
+    }
+    return entry;
+}
+
+/***********************************************************************
+ *           remove_file_info_cache
+ *
+ * Drop the cached metadata of a handle that is being closed.
+ */
+void remove_file_info_cache( HANDLE handle )
+{
+    struct file_info_cache_entry *entry;
+
+    if (!file_info_cache_timeout()) return;
+
+    mutex_lock( &file_info_mutex );
+    entry = file_info_cache_slot( handle );
+    if (entry->handle == handle) clear_file_info_entry( entry );
+    mutex_unlock( &file_info_mutex );
+}
+
+/* same as fd_get_file_info, but using the cache when possible */
+static int cached_fd_get_file_info( HANDLE handle, int fd, BOOL needs_close, unsigned int options,
+                                    struct stat *st, ULONG *attr )
+{
+    struct file_info_cache_entry *entry;
+    LONG generation;
+    int ret;
+
+    if (needs_close || !file_info_cache_timeout()) return fd_get_file_info( fd, options, st, attr );
+
+    mutex_lock( &file_info_mutex );
+    if ((entry = get_file_info_entry( handle, fd, FILE_INFO_FD_STAT )) && entry->options == options)
+    {
+        *st = entry->st;
+        *attr = entry->attr;
+        mutex_unlock( &file_info_mutex );
+        return 0;
+    }
+    generation = file_info_generation;
+    mutex_unlock( &file_info_mutex );
+
+    if ((ret = fd_get_file_info( fd, options, st, attr )) == -1) return ret;
+
+    mutex_lock( &file_info_mutex );
+    if ((entry = alloc_file_info_entry( handle, fd, generation )))
+    {
+        entry->st = *st;
+        entry->attr = *attr;
+        entry->options = options;
+        entry->valid |= FILE_INFO_FD_STAT;
+    }
+    mutex_unlock( &file_info_mutex );
+    return ret;
+}
+
+/* same as server_get_unix_name, but using the cache when possible */
+static NTSTATUS cached_get_unix_name( HANDLE handle, int fd, BOOL needs_close, char * HOSTPTR * HOSTPTR unix_name )
+{
+    struct file_info_cache_entry *entry;
+    char * HOSTPTR name;
+    LONG generation;
+    NTSTATUS status;
+
+    if (needs_close || !file_info_cache_timeout()) return server_get_unix_name( handle, unix_name );
+
+    mutex_lock( &file_info_mutex );
+    if ((entry = get_file_info_entry( handle, fd, FILE_INFO_NAME )))
+    {
+        name = strdup( entry->unix_name );
+        mutex_unlock( &file_info_mutex );
+        if (!name) return STATUS_NO_MEMORY;
+        *unix_name = name;
+        return STATUS_SUCCESS;
+    }
+    generation = file_info_generation;
+    mutex_unlock( &file_info_mutex );
+
+    if ((status = server_get_unix_name( handle, unix_name ))) return status;
+
+    mutex_lock( &file_info_mutex );
+    if ((entry = alloc_file_info_entry( handle, fd, generation )) && !(entry->valid & FILE_INFO_NAME) &&
+        (entry->unix_name = strdup( *unix_name )))
+        entry->valid |= FILE_INFO_NAME;
+    mutex_unlock( &file_info_mutex );
+    return status;
+}
+
+/* same as get_file_info on the name of the handle, but using the cache when possible */
+static int cached_get_file_info( HANDLE handle, int fd, BOOL needs_close, const char * HOSTPTR unix_name,
+                                 struct stat *st, ULONG *attr )
+{
+    struct file_info_cache_entry *entry;
+    LONG generation;
+    int ret;
+
+    if (needs_close || !file_info_cache_timeout()) return get_file_info( unix_name, st, attr );
+
+    mutex_lock( &file_info_mutex );
+    if ((entry = get_file_info_entry( handle, fd, FILE_INFO_NAME_STAT )))
+    {
+        *st = entry->name_st;
+        *attr = entry->name_attr;
+        mutex_unlock( &file_info_mutex );
+        return 0;
+    }
+    generation = file_info_generation;
+    mutex_unlock( &file_info_mutex );
+
+    if ((ret = get_file_info( unix_name, st, attr )) == -1) return ret;
+
+    mutex_lock( &file_info_mutex );
+    if ((entry = alloc_file_info_entry( handle, fd, generation )))
+    {
+        entry->name_st = *st;
+        entry->name_attr = *attr;
+        entry->valid |= FILE_INFO_NAME_STAT;
+    }
+    mutex_unlock( &file_info_mutex );
+    return ret;
+}
+
 #include <wine/hostaddrspace_enter.h>
 
 static NTSTATUS fill_name_info( const char *unix_name, FILE_NAME_INFORMATION *info, LONG *name_len )
@@ -1999,6 +2228,33 @@ static NTSTATUS get_mountmgr_fs_info( HANDLE handle, int fd, struct mountmgr_uni
 }
 
 
+/* get the stat info and attributes of a directory entry; same as get_file_info, but
+ * using the identity of the directory being listed to detect mount points */
+static int get_dir_entry_info( const struct dir_data *data, const struct dir_data_names *names,
+                               struct stat *st, ULONG *attr )
+{
+    const char *name = names->unix_name;
+    int ret;
+
+    if (!strcmp( name, "." ) || !strcmp( name, ".." )) return get_file_info( name, st, attr );
+
+    *attr = 0;
+    ret = lstat( name, st );
+    if (ret == -1) return ret;
+    if (S_ISLNK( st->st_mode ))
+    {
+        ret = stat( name, st );
+        if (ret == -1) return ret;
+        /* is a symbolic link and a directory, consider these "reparse points" */
+        if (S_ISDIR( st->st_mode )) *attr |= FILE_ATTRIBUTE_REPARSE_POINT;
+    }
+    else if (S_ISDIR( st->st_mode ) && (st->st_dev != data->id.dev || st->st_ino == data->id.ino))
+        *attr |= FILE_ATTRIBUTE_REPARSE_POINT;
+    *attr |= get_file_attributes( st );
+    return ret;
+}
+
+
 /***********************************************************************
  *           get_dir_data_entry
  *
@@ -2013,15 +2269,29 @@ static NTSTATUS get_dir_data_entry( struct dir_data *dir_data, void *info_ptr, I
     struct stat st;
     ULONG name_len, start, dir_size, attributes;
 
-    if (get_file_info( names->unix_name, &st, &attributes ) == -1)
+    /* only the name is needed; the ignored files are all directories, so for entries of any
+     * other known type it is enough to check that they haven't been deleted since the listing */
+    if (class == FileNamesInformation && names->type != DT_UNKNOWN &&
+        names->type != DT_DIR && names->type != DT_LNK)
     {
-        TRACE( "file no longer exists %s\n", names->unix_name );
-        return STATUS_SUCCESS;
+        if (access( names->unix_name, F_OK ) == -1)
+        {
+            TRACE( "file no longer exists %s\n", names->unix_name );
+            return STATUS_SUCCESS;
+        }
     }
-    if (is_ignored_file( &st ))
+    else
     {
-        TRACE( "ignoring file %s\n", names->unix_name );
-        return STATUS_SUCCESS;
+        if (get_dir_entry_info( dir_data, names, &st, &attributes ) == -1)
+        {
+            TRACE( "file no longer exists %s\n", names->unix_name );
+            return STATUS_SUCCESS;
+        }
+        if (is_ignored_file( &st ))
+        {
+            TRACE( "ignoring file %s\n", names->unix_name );
+            return STATUS_SUCCESS;
+        }
     }
     start = dir_info_align( io->Information );
     dir_size = dir_info_size( class, 0 );
@@ -2125,8 +2395,8 @@ static NTSTATUS read_directory_data_vfat( struct dir_data *data, int fd, const U
         de[0].d_reclen = 0;
     }
 
-    if (!append_entry( data, ".", NULL, mask )) goto done;
-    if (!append_entry( data, "..", NULL, mask )) goto done;
+    if (!append_entry( data, ".", NULL, mask, DT_DIR )) goto done;
+    if (!append_entry( data, "..", NULL, mask, DT_DIR )) goto done;
 
     while (de[0].d_reclen)
     {
@@ -2142,7 +2412,7 @@ static NTSTATUS read_directory_data_vfat( struct dir_data *data, int fd, const U
                 long_name = de[0].d_name;
                 short_name = NULL;
             }
-            if (!append_entry( data, long_name, short_name, mask )) goto done;
+            if (!append_entry( data, long_name, short_name, mask, DT_UNKNOWN )) goto done;
         }
         if (ioctl( fd, VFAT_IOCTL_READDIR_BOTH, (long)de ) == -1) break;
     }
@@ -2191,7 +2461,7 @@ static NTSTATUS read_directory_data_getattrlist( struct dir_data *data, const ch
 
     TRACE( "found %s\n", buffer.name );
 
-    if (!append_entry( data, buffer.name, NULL, NULL )) return STATUS_NO_MEMORY;
+    if (!append_entry( data, buffer.name, NULL, NULL, DT_UNKNOWN )) return STATUS_NO_MEMORY;
 
     return STATUS_SUCCESS;
 }
@@ -2214,7 +2484,7 @@ static NTSTATUS read_directory_data_stat( struct dir_data *data, const char *uni
 
     TRACE( "found %s\n", unix_name );
 
-    if (!append_entry( data, unix_name, NULL, NULL )) return STATUS_NO_MEMORY;
+    if (!append_entry( data, unix_name, NULL, NULL, DT_UNKNOWN )) return STATUS_NO_MEMORY;
 
     return STATUS_SUCCESS;
 }
@@ -2233,12 +2503,12 @@ static NTSTATUS read_directory_data_readdir( struct dir_data *data, const UNICOD
 
     if (!dir) return STATUS_NO_SUCH_FILE;
 
-    if (!append_entry( data, ".", NULL, mask )) goto done;
-    if (!append_entry( data, "..", NULL, mask )) goto done;
+    if (!append_entry( data, ".", NULL, mask, DT_DIR )) goto done;
+    if (!append_entry( data, "..", NULL, mask, DT_DIR )) goto done;
     while ((de = readdir( dir )))
     {
         if (!strcmp( de->d_name, "." ) || !strcmp( de->d_name, ".." )) continue;
-        if (!append_entry( data, de->d_name, NULL, mask )) goto done;
+        if (!append_entry( data, de->d_name, NULL, mask, DIRENT_TYPE( de ) )) goto done;
     }
     status = STATUS_SUCCESS;
 
@@ -2247,6 +2517,65 @@ done:
     return status;
 }
 
+#if defined(__linux__) && defined(__NR_getdents64)
+
+struct linux_dirent64
+{
+    ULONG64        d_ino;
+    LONG64         d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[1];
+};
+
+/***********************************************************************
+ *           read_directory_getdents
+ *
+ * Read a directory using the getdents64 syscall with a large buffer; helper for NtQueryDirectoryFile.
+ */
+static NTSTATUS read_directory_data_getdents( struct dir_data *data, const UNICODE_STRING *mask )
+{
+    static const unsigned int buffer_size = 0x10000;
+    struct linux_dirent64 *de;
+    NTSTATUS status = STATUS_NO_MEMORY;
+    char *buffer;
+    long size, pos;
+    int fd;
+
+    if (!(buffer = malloc( buffer_size ))) return STATUS_NO_MEMORY;
+    if ((fd = open( ".", O_RDONLY | O_DIRECTORY )) == -1)
+    {
+        free( buffer );
+        return STATUS_NO_SUCH_FILE;
+    }
+    if ((size = syscall( __NR_getdents64, fd, buffer, buffer_size )) == -1)
+    {
+        status = STATUS_NOT_SUPPORTED;
+        goto done;
+    }
+
+    if (!append_entry( data, ".", NULL, mask, DT_DIR )) goto done;
+    if (!append_entry( data, "..", NULL, mask, DT_DIR )) goto done;
+    while (size > 0)
+    {
+        for (pos = 0; pos < size; pos += de->d_reclen)
+        {
+            de = (struct linux_dirent64 *)(buffer + pos);
+            if (!strcmp( de->d_name, "." ) || !strcmp( de->d_name, ".." )) continue;
+            if (!append_entry( data, de->d_name, NULL, mask, de->d_type )) goto done;
+        }
+        size = syscall( __NR_getdents64, fd, buffer, buffer_size );
+    }
+    status = size ? errno_to_status( errno ) : STATUS_SUCCESS;
+
+done:
+    close( fd );
+    free( buffer );
+    return status;
+}
+
+#endif /* __linux__ && __NR_getdents64 */
+
 
 /***********************************************************************
  *           read_directory_data
@@ -2277,6 +2606,9 @@ static NTSTATUS read_directory_data( struct dir_data *data, int fd, const UNICOD
         }
     }
 
+#if defined(__linux__) && defined(__NR_getdents64)
+    if ((status = read_directory_data_getdents( data, mask )) != STATUS_NOT_SUPPORTED) return status;
+#endif
     return read_directory_data_readdir( data, mask );
 }
 
@@ -3803,6 +4135,7 @@ NTSTATUS WINAPI NtCreateFile( HANDLE *handle, ACCESS_MASK access, OBJECT_ATTRIBU
         status = open_unix_file( handle, unix_name, access, &new_attr, attributes,
                                  sharing, disposition, options, ea_buffer, ea_length );
         free( unix_name );
+        if (disposition != FILE_OPEN) invalidate_file_info_cache();
     }
     else WARN( "%s not found (%x)\n", debugstr_us(attr->ObjectName), status );
 
@@ -3947,7 +4280,10 @@ NTSTATUS WINAPI NtDeleteFile( OBJECT_ATTRIBUTES *attr )
         if (!(status = open_unix_file( &handle, unix_name, GENERIC_READ | GENERIC_WRITE | DELETE, &new_attr,
                                        0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, FILE_OPEN,
                                        FILE_DELETE_ON_CLOSE, NULL, 0 )))
+        {
             NtClose( handle );
+            invalidate_file_info_cache();
+        }
         free( unix_name );
     }
     free( nt_name.Buffer );
@@ -4134,7 +4470,7 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
     switch (class)
     {
     case FileBasicInformation:
-        if (fd_get_file_info( fd, options, &st, &attr ) == -1)
+        if (cached_fd_get_file_info( handle, fd, needs_close, options, &st, &attr ) == -1)
             status = errno_to_status( errno );
         else if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode))
             status = STATUS_INVALID_INFO_CLASS;
@@ -4145,7 +4481,8 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         {
             FILE_STANDARD_INFORMATION *info = ptr;
 
-            if (fd_get_file_info( fd, options, &st, &attr ) == -1) status = errno_to_status( errno );
+            if (cached_fd_get_file_info( handle, fd, needs_close, options, &st, &attr ) == -1)
+                status = errno_to_status( errno );
             else
             {
                 fill_file_info( &st, attr, info, class );
@@ -4162,7 +4499,8 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         }
         break;
     case FileInternalInformation:
-        if (fd_get_file_info( fd, options, &st, &attr ) == -1) status = errno_to_status( errno );
+        if (cached_fd_get_file_info( handle, fd, needs_close, options, &st, &attr ) == -1)
+            status = errno_to_status( errno );
         else fill_file_info( &st, attr, ptr, class );
         break;
     case FileEaInformation:
@@ -4172,7 +4510,8 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         }
         break;
     case FileEndOfFileInformation:
-        if (fd_get_file_info( fd, options, &st, &attr ) == -1) status = errno_to_status( errno );
+        if (cached_fd_get_file_info( handle, fd, needs_close, options, &st, &attr ) == -1)
+            status = errno_to_status( errno );
         else fill_file_info( &st, attr, ptr, class );
         break;
     case FileAllInformation:
@@ -4180,10 +4519,11 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
             FILE_ALL_INFORMATION *info = ptr;
             char * HOSTPTR unix_name;
 
-            if (fd_get_file_info( fd, options, &st, &attr ) == -1) status = errno_to_status( errno );
+            if (cached_fd_get_file_info( handle, fd, needs_close, options, &st, &attr ) == -1)
+                status = errno_to_status( errno );
             else if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode))
                 status = STATUS_INVALID_INFO_CLASS;
-            else if (!(status = server_get_unix_name( handle, &unix_name )))
+            else if (!(status = cached_get_unix_name( handle, fd, needs_close, &unix_name )))
             {
                 LONG name_len = len - FIELD_OFFSET(FILE_ALL_INFORMATION, NameInformation.FileName);
 
@@ -4244,7 +4584,7 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
             FILE_NAME_INFORMATION *info = ptr;
             char * HOSTPTR unix_name;
 
-            if (!(status = server_get_unix_name( handle, &unix_name )))
+            if (!(status = cached_get_unix_name( handle, fd, needs_close, &unix_name )))
             {
                 LONG name_len = len - FIELD_OFFSET(FILE_NAME_INFORMATION, FileName);
                 status = fill_name_info( unix_name, info, &name_len );
@@ -4258,12 +4598,12 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
             FILE_NETWORK_OPEN_INFORMATION *info = ptr;
             char * HOSTPTR unix_name;
 
-            if (!(status = server_get_unix_name( handle, &unix_name )))
+            if (!(status = cached_get_unix_name( handle, fd, needs_close, &unix_name )))
             {
                 ULONG attributes;
                 struct stat st;
 
-                if (get_file_info( unix_name, &st, &attributes ) == -1)
+                if (cached_get_file_info( handle, fd, needs_close, unix_name, &st, &attributes ) == -1)
                     status = errno_to_status( errno );
                 else if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode))
                     status = STATUS_INVALID_INFO_CLASS;
@@ -4288,7 +4628,8 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         }
         break;
     case FileIdInformation:
-        if (fd_get_file_info( fd, options, &st, &attr ) == -1) status = errno_to_status( errno );
+        if (cached_fd_get_file_info( handle, fd, needs_close, options, &st, &attr ) == -1)
+            status = errno_to_status( errno );
         else
         {
             struct mountmgr_unix_drive drive;
@@ -4302,7 +4643,8 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         }
         break;
     case FileAttributeTagInformation:
-        if (fd_get_file_info( fd, options, &st, &attr ) == -1) status = errno_to_status( errno );
+        if (cached_fd_get_file_info( handle, fd, needs_close, options, &st, &attr ) == -1)
+            status = errno_to_status( errno );
         else
         {
             FILE_ATTRIBUTE_TAG_INFORMATION *info = ptr;
@@ -4625,6 +4967,23 @@ NTSTATUS WINAPI NtSetInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         status = STATUS_NOT_IMPLEMENTED;
         break;
     }
+    /* the cached metadata may have been retrieved while the change was in progress */
+    if (!status)
+    {
+        switch (class)
+        {
+        case FileBasicInformation:
+        case FileEndOfFileInformation:
+        case FileAllocationInformation:
+        case FileRenameInformation:
+        case FileLinkInformation:
+        case FileDispositionInformation:
+            invalidate_file_info_cache();
+            break;
+        default:
+            break;
+        }
+    }
     io->Information = 0;
     return io->u.Status = status;
 }
@@ -4793,6 +5152,7 @@ static BOOL async_write_proc( void *user, ULONG_PTR *info, NTSTATUS *status )
         }
         else
         {
+            if (result && type == FD_TYPE_FILE) invalidate_file_info_cache();
             fileio->already += result;
             if (fileio->already < fileio->count) return FALSE;
             *status = STATUS_SUCCESS;
@@ -5121,6 +5481,371 @@ static NTSTATUS set_pending_write( HANDLE device )
 }
 
 
+#if defined(__linux__) && defined(__NR_futex)
+
+/* Synchronous byte mode pipes can optionally be backed by a pair of shared memory
+ * rings, set up by the server when both ends are opened for synchronous I/O.  The
+ * server end's fd maps the rings and the client end gets a duplicate of it once it
+ * connects.  Data then moves directly between the processes; the server is only
+ * involved for connection state changes, which it reports by updating the shared
+ * state and waking up the ring futexes. */
+
+struct pipe_shm_map
+{
+    struct list      entry;
+    int              fd;       /* cached unix fd of the pipe end */
+    LONG             refs;
+    struct pipe_shm *shm;
+    unsigned int     index;    /* index of the ring read by this end */
+    unsigned int     conn_id;  /* connection of a client end, 0 for the server end */
+};
+
+static struct list pipe_shm_maps = LIST_INIT( pipe_shm_maps );
+static pthread_mutex_t pipe_shm_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static inline int pipe_shm_futex_wait( int *addr, int val, const struct timespec *timeout )
+{
+    return syscall( __NR_futex, addr, 0 /* FUTEX_WAIT */, val, timeout, 0, 0 );
+}
+
+static inline void pipe_shm_futex_wake( int *addr, int count )
+{
+    syscall( __NR_futex, addr, 1 /* FUTEX_WAKE */, count, NULL, 0, 0 );
+}
+
+/* the lock records which process holds it, so that the server can release it if that process dies */
+static void pipe_shm_lock( struct pipe_shm_ring *ring )
+{
+    int owner = PIPE_SHM_LOCK_OWNER( HandleToULong( NtCurrentTeb()->ClientId.UniqueProcess )), c, prev;
+
+    if (!(c = InterlockedCompareExchange( &ring->lock, owner, 0 ))) return;
+    for (;;)
+    {
+        if (!c)
+        {
+            /* other threads may still be waiting, so keep the lock marked as contended */
+            if (!(c = InterlockedCompareExchange( &ring->lock, owner | PIPE_SHM_LOCK_CONTENDED, 0 ))) return;
+            continue;
+        }
+        if (!(c & PIPE_SHM_LOCK_CONTENDED) &&
+            (prev = InterlockedCompareExchange( &ring->lock, c | PIPE_SHM_LOCK_CONTENDED, c )) != c)
+        {
+            c = prev;
+            continue;
+        }
+        pipe_shm_futex_wait( &ring->lock, c | PIPE_SHM_LOCK_CONTENDED, NULL );
+        c = 0;
+    }
+}
+
+static void pipe_shm_unlock( struct pipe_shm_ring *ring )
+{
+    if (InterlockedExchange( &ring->lock, 0 ) & PIPE_SHM_LOCK_CONTENDED) pipe_shm_futex_wake( &ring->lock, 1 );
+}
+
+/* wait for a change of the ring or the connection state since seq was read; called with the ring lock held.
+ * Alertable waits return STATUS_USER_APC if user APCs have been run in the meantime. */
+static NTSTATUS pipe_shm_wait( struct pipe_shm_ring *ring, int seq, BOOL alertable )
+{
+    static const struct timespec slice = { 0, 50000000 };
+    LARGE_INTEGER zero = {{0}};
+    NTSTATUS status = STATUS_SUCCESS;
+
+    ring->waiters++;
+    pipe_shm_unlock( ring );
+    if (!alertable) pipe_shm_futex_wait( &ring->seq, seq, NULL );
+    /* user APCs are only delivered through the server, so poll for them between futex waits */
+    else if (pipe_shm_futex_wait( &ring->seq, seq, &slice ) == -1 && errno == ETIMEDOUT)
+        status = NtDelayExecution( TRUE, &zero );
+    pipe_shm_lock( ring );
+    ring->waiters--;
+    return status;
+}
+
+/* the server updates the connection state without taking the ring locks, so the sequence
+ * has to be read before checking the state to not miss its wake up */
+static inline int pipe_shm_get_seq( struct pipe_shm_ring *ring )
+{
+    return __atomic_load_n( &ring->seq, __ATOMIC_ACQUIRE );
+}
+
+/* wake up the waiters after a change of the ring; called with the ring lock held */
+static void pipe_shm_signal( struct pipe_shm_ring *ring )
+{
+    InterlockedIncrement( &ring->seq );
+    if (ring->waiters) pipe_shm_futex_wake( &ring->seq, INT_MAX );
+}
+
+static char *pipe_shm_data( const struct pipe_shm_map *map, unsigned int index )
+{
+    return (char *)map->shm + PIPE_SHM_DATA_OFFSET + index * PIPE_SHM_RING_SIZE;
+}
+
+/* check that the rings are used for the connection of the pipe end; called with a ring lock held */
+static BOOL pipe_shm_usable( const struct pipe_shm_map *map )
+{
+    const struct pipe_shm *shm = map->shm;
+
+    if (!shm->enabled || (map->conn_id && map->conn_id != shm->conn_id)) return FALSE;
+    return shm->state == FILE_PIPE_CONNECTED_STATE || shm->state == FILE_PIPE_CLOSING_STATE;
+}
+
+static void release_pipe_shm_map( struct pipe_shm_map *map )
+{
+    if (InterlockedDecrement( &map->refs )) return;
+    munmap( map->shm, PIPE_SHM_SIZE );
+    free( map );
+}
+
+static struct pipe_shm_map *grab_pipe_shm_map( HANDLE handle )
+{
+    struct pipe_shm_map *map, *new_map;
+    enum server_fd_type type;
+    int fd;
+
+    if (server_get_cached_unix_fd( handle, &fd, &type ) || type != FD_TYPE_PIPE) return NULL;
+
+    mutex_lock( &pipe_shm_mutex );
+    LIST_FOR_EACH_ENTRY( map, &pipe_shm_maps, struct pipe_shm_map, entry )
+    {
+        if (map->fd != fd) continue;
+        InterlockedIncrement( &map->refs );
+        mutex_unlock( &pipe_shm_mutex );
+        return map;
+    }
+    mutex_unlock( &pipe_shm_mutex );
+
+    if (!(new_map = malloc( sizeof(*new_map) ))) return NULL;
+    new_map->fd = fd;
+    new_map->refs = 2;  /* one for the list, one for the caller */
+
+    SERVER_START_REQ( get_named_pipe_shm_info )
+    {
+        req->handle = wine_server_obj_handle( handle );
+        if (wine_server_call( req ))
+        {
+            free( new_map );
+            new_map = NULL;
+        }
+        else
+        {
+            new_map->index = reply->server_end ? 0 : 1;
+            new_map->conn_id = reply->server_end ? 0 : reply->conn_id;
+        }
+    }
+    SERVER_END_REQ;
+    if (!new_map) return NULL;
+
+    new_map->shm = mmap( NULL, PIPE_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if (new_map->shm == MAP_FAILED)
+    {
+        free( new_map );
+        return NULL;
+    }
+
+    mutex_lock( &pipe_shm_mutex );
+    LIST_FOR_EACH_ENTRY( map, &pipe_shm_maps, struct pipe_shm_map, entry )
+    {
+        if (map->fd != fd) continue;
+        /* another thread got there first */
+        InterlockedIncrement( &map->refs );
+        mutex_unlock( &pipe_shm_mutex );
+        munmap( new_map->shm, PIPE_SHM_SIZE );
+        free( new_map );
+        return map;
+    }
+    list_add_head( &pipe_shm_maps, &new_map->entry );
+    mutex_unlock( &pipe_shm_mutex );
+    return new_map;
+}
+
+/***********************************************************************
+ *           release_pipe_shm
+ *
+ * Called when the cached fd of a pipe end is removed from the fd cache.
+ */
+void release_pipe_shm( int fd )
+{
+    struct pipe_shm_map *map;
+
+    mutex_lock( &pipe_shm_mutex );
+    LIST_FOR_EACH_ENTRY( map, &pipe_shm_maps, struct pipe_shm_map, entry )
+    {
+        if (map->fd != fd) continue;
+        list_remove( &map->entry );
+        mutex_unlock( &pipe_shm_mutex );
+        release_pipe_shm_map( map );
+        return;
+    }
+    mutex_unlock( &pipe_shm_mutex );
+}
+
+/* read from the shared memory ring; returns FALSE if the server needs to handle the read */
+static BOOL pipe_shm_read( HANDLE handle, void *buffer, ULONG length, BOOL alertable,
+                           ULONG *total, NTSTATUS *status )
+{
+    struct pipe_shm_map *map;
+    struct pipe_shm_ring *ring;
+    const char *data;
+    unsigned int avail, pos, len;
+    BOOL ret = FALSE;
+    int seq;
+
+    if (!(map = grab_pipe_shm_map( handle ))) return FALSE;
+    ring = &map->shm->ring[map->index];
+    data = pipe_shm_data( map, map->index );
+
+    pipe_shm_lock( ring );
+    for (;;)
+    {
+        seq = pipe_shm_get_seq( ring );
+        if (!pipe_shm_usable( map )) break;
+        if ((avail = ring->head - ring->tail))
+        {
+            avail = min( avail, length );
+            pos = ring->tail % PIPE_SHM_RING_SIZE;
+            len = min( avail, PIPE_SHM_RING_SIZE - pos );
+            memcpy( buffer, data + pos, len );
+            memcpy( (char *)buffer + len, data, avail - len );
+            ring->tail += avail;
+            pipe_shm_signal( ring );
+            *total = avail;
+            *status = STATUS_SUCCESS;
+            ret = TRUE;
+            break;
+        }
+        /* let the server report the broken pipe once the data is drained */
+        if (map->shm->state != FILE_PIPE_CONNECTED_STATE) break;
+        if (ring->nonblocking)
+        {
+            *status = STATUS_PIPE_EMPTY;
+            ret = TRUE;
+            break;
+        }
+        if (pipe_shm_wait( ring, seq, alertable ) == STATUS_USER_APC)
+        {
+            *status = STATUS_USER_APC;
+            ret = TRUE;
+            break;
+        }
+    }
+    pipe_shm_unlock( ring );
+
+    release_pipe_shm_map( map );
+    return ret;
+}
+
+/* write to the shared memory ring; returns FALSE if the server needs to handle the write */
+static BOOL pipe_shm_write( HANDLE handle, const void *buffer, ULONG length, BOOL alertable,
+                            ULONG *total, NTSTATUS *status )
+{
+    struct pipe_shm_map *map;
+    struct pipe_shm_ring *ring;
+    char *data;
+    unsigned int space, pos, len;
+    BOOL nonblocking, alerted = FALSE, ret = FALSE;
+    int seq;
+
+    if (!(map = grab_pipe_shm_map( handle ))) return FALSE;
+    ring = &map->shm->ring[!map->index];
+    data = pipe_shm_data( map, !map->index );
+    nonblocking = map->shm->ring[map->index].nonblocking;
+
+    *total = 0;
+    pipe_shm_lock( ring );
+    for (;;)
+    {
+        seq = pipe_shm_get_seq( ring );
+        if (!pipe_shm_usable( map ) || map->shm->state != FILE_PIPE_CONNECTED_STATE) break;
+        ret = TRUE;
+        if (*total == length) break;
+        if ((space = PIPE_SHM_RING_SIZE - (ring->head - ring->tail)))
+        {
+            space = min( space, length - *total );
+            pos = ring->head % PIPE_SHM_RING_SIZE;
+            len = min( space, PIPE_SHM_RING_SIZE - pos );
+            memcpy( data + pos, (const char *)buffer + *total, len );
+            memcpy( data, (const char *)buffer + *total + len, space - len );
+            ring->head += space;
+            *total += space;
+            pipe_shm_signal( ring );
+            continue;
+        }
+        if (nonblocking) break;
+        /* once part of the data has been written, the write has to complete */
+        if (pipe_shm_wait( ring, seq, alertable ) == STATUS_USER_APC && !*total)
+        {
+            alerted = TRUE;
+            break;
+        }
+    }
+    if (alerted) *status = STATUS_USER_APC;
+    else if (ret && *total != length && !nonblocking)
+    {
+        /* the connection went away while we were waiting */
+        if (pipe_shm_usable( map ) && map->shm->state == FILE_PIPE_CLOSING_STATE)
+            *status = STATUS_PIPE_BROKEN;
+        else
+            *status = STATUS_PIPE_DISCONNECTED;
+    }
+    else *status = STATUS_SUCCESS;
+    pipe_shm_unlock( ring );
+
+    release_pipe_shm_map( map );
+    return ret;
+}
+
+/* wait for the other end to read all the data; returns FALSE if the server needs to handle the flush */
+static BOOL pipe_shm_flush( HANDLE handle )
+{
+    struct pipe_shm_map *map;
+    struct pipe_shm_ring *ring;
+    BOOL ret = FALSE;
+    int seq;
+
+    if (!(map = grab_pipe_shm_map( handle ))) return FALSE;
+    ring = &map->shm->ring[!map->index];
+
+    pipe_shm_lock( ring );
+    for (;;)
+    {
+        seq = pipe_shm_get_seq( ring );
+        if (!pipe_shm_usable( map ) || map->shm->state != FILE_PIPE_CONNECTED_STATE) break;
+        if ((ret = (ring->head == ring->tail))) break;
+        pipe_shm_wait( ring, seq, FALSE );
+    }
+    pipe_shm_unlock( ring );
+
+    release_pipe_shm_map( map );
+    return ret;
+}
+
+#else
+
+void release_pipe_shm( int fd )
+{
+}
+
+static BOOL pipe_shm_read( HANDLE handle, void *buffer, ULONG length, BOOL alertable,
+                           ULONG *total, NTSTATUS *status )
+{
+    return FALSE;
+}
+
+static BOOL pipe_shm_write( HANDLE handle, const void *buffer, ULONG length, BOOL alertable,
+                            ULONG *total, NTSTATUS *status )
+{
+    return FALSE;
+}
+
+static BOOL pipe_shm_flush( HANDLE handle )
+{
+    return FALSE;
+}
+
+#endif
+
+
 /******************************************************************************
  *              NtReadFile   (NTDLL.@)
  */
@@ -5149,7 +5874,13 @@ NTSTATUS WINAPI NtReadFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, vo
     if (!virtual_check_buffer_for_write( buffer, length )) return STATUS_ACCESS_VIOLATION;
 
     if (status == STATUS_BAD_DEVICE_TYPE)
-        return server_read_file( handle, event, apc, apc_user, io, buffer, length, offset, key );
+    {
+        if (!pipe_shm_read( handle, buffer, length, options & FILE_SYNCHRONOUS_IO_ALERT, &total, &status ))
+            return server_read_file( handle, event, apc, apc_user, io, buffer, length, offset, key );
+        async_read = FALSE;
+        if (status) goto err;
+        goto done;
+    }
 
     async_read = !(options & (FILE_SYNCHRONOUS_IO_ALERT | FILE_SYNCHRONOUS_IO_NONALERT));
 
@@ -5318,6 +6049,58 @@ err:
 }
 
 
+/* maximum number of page segments transferred in a single system call */
+#define MAX_SEGMENT_IOV 256
+
+#if defined(HAVE_PREADV) || defined(HAVE_PWRITEV)
+static unsigned int segments_to_iov( struct iovec *iov, const FILE_SEGMENT_ELEMENT *segments,
+                                     ULONG pos, ULONG length )
+{
+    unsigned int count = 0;
+
+    while (length && count < MAX_SEGMENT_IOV)
+    {
+        iov[count].iov_base = (char *)segments[count].Buffer + pos;
+        iov[count].iov_len = min( length, page_size - pos );
+        length -= iov[count++].iov_len;
+        pos = 0;
+    }
+    return count;
+}
+#endif
+
+/* read into the page segments starting at pos; offset is -1 to use the file pointer */
+static ssize_t read_segments( int fd, const FILE_SEGMENT_ELEMENT *segments, ULONG pos, ULONG length,
+                              off_t offset )
+{
+#ifdef HAVE_PREADV
+    struct iovec iov[MAX_SEGMENT_IOV];
+    unsigned int count = segments_to_iov( iov, segments, pos, length );
+
+    if (offset == -1) return readv( fd, iov, count );
+    return preadv( fd, iov, count, offset );
+#else
+    if (offset == -1) return read( fd, (char *)segments->Buffer + pos, min( length, page_size - pos ));
+    return pread( fd, (char *)segments->Buffer + pos, min( length, page_size - pos ), offset );
+#endif
+}
+
+/* write from the page segments starting at pos; offset is -1 to use the file pointer */
+static ssize_t write_segments( int fd, const FILE_SEGMENT_ELEMENT *segments, ULONG pos, ULONG length,
+                               off_t offset )
+{
+#ifdef HAVE_PWRITEV
+    struct iovec iov[MAX_SEGMENT_IOV];
+    unsigned int count = segments_to_iov( iov, segments, pos, length );
+
+    if (offset == -1) return writev( fd, iov, count );
+    return pwritev( fd, iov, count, offset );
+#else
+    if (offset == -1) return write( fd, (char *)segments->Buffer + pos, min( length, page_size - pos ));
+    return pwrite( fd, (char *)segments->Buffer + pos, min( length, page_size - pos ), offset );
+#endif
+}
+
 /******************************************************************************
  *              NtReadFileScatter   (NTDLL.@)
  */
@@ -5353,10 +6136,9 @@ NTSTATUS WINAPI NtReadFileScatter( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
     while (length)
     {
         if (offset && offset->QuadPart != FILE_USE_FILE_POINTER_POSITION)
-            result = pread( unix_handle, (char *)segments->Buffer + pos,
-                            min( length - pos, page_size - pos ), offset->QuadPart + total );
+            result = read_segments( unix_handle, segments, pos, length, offset->QuadPart + total );
         else
-            result = read( unix_handle, (char *)segments->Buffer + pos, min( length - pos, page_size - pos ) );
+            result = read_segments( unix_handle, segments, pos, length, -1 );
 
         if (result == -1)
         {
@@ -5367,11 +6149,9 @@ NTSTATUS WINAPI NtReadFileScatter( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
         if (!result) break;
         total += result;
         length -= result;
-        if ((pos += result) == page_size)
-        {
-            pos = 0;
-            segments++;
-        }
+        pos += result;
+        segments += pos / page_size;
+        pos %= page_size;
     }
 
     if (total == 0) status = STATUS_END_OF_FILE;
@@ -5437,7 +6217,13 @@ NTSTATUS WINAPI NtWriteFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, v
     }
 
     if (status == STATUS_BAD_DEVICE_TYPE)
-        return server_write_file( handle, event, apc, apc_user, io, buffer, length, offset, key );
+    {
+        if (!pipe_shm_write( handle, buffer, length, options & FILE_SYNCHRONOUS_IO_ALERT, &total, &status ))
+            return server_write_file( handle, event, apc, apc_user, io, buffer, length, offset, key );
+        async_write = FALSE;
+        if (status) goto err;
+        goto done;
+    }
 
     if (type == FD_TYPE_FILE)
     {
@@ -5596,6 +6382,7 @@ done:
 
 err:
     if (needs_close) close( unix_handle );
+    if (type == FD_TYPE_FILE && total) invalidate_file_info_cache();
 
     if (type == FD_TYPE_SERIAL && (status == STATUS_SUCCESS || status == STATUS_PENDING))
         set_pending_write( handle );
@@ -5656,10 +6443,9 @@ NTSTATUS WINAPI NtWriteFileGather( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
     while (length)
     {
         if (offset && offset->QuadPart != FILE_USE_FILE_POINTER_POSITION)
-            result = pwrite( unix_handle, (char *)segments->Buffer + pos,
-                             page_size - pos, offset->QuadPart + total );
+            result = write_segments( unix_handle, segments, pos, length, offset->QuadPart + total );
         else
-            result = write( unix_handle, (char *)segments->Buffer + pos, page_size - pos );
+            result = write_segments( unix_handle, segments, pos, length, -1 );
 
         if (result == -1)
         {
@@ -5679,17 +6465,16 @@ NTSTATUS WINAPI NtWriteFileGather( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
         }
         total += result;
         length -= result;
-        if ((pos += result) == page_size)
-        {
-            pos = 0;
-            segments++;
-        }
+        pos += result;
+        segments += pos / page_size;
+        pos %= page_size;
     }
 
     send_completion = cvalue != 0;
 
  done:
     if (needs_close) close( unix_handle );
+    if (total) invalidate_file_info_cache();
     if (status == STATUS_SUCCESS)
     {
         io->u.Status = status;
@@ -5902,6 +6687,12 @@ NTSTATUS WINAPI NtFlushBuffersFile( HANDLE handle, IO_STATUS_BLOCK *io )
     {
         ret = serial_FlushBuffersFile( fd );
     }
+    else if (ret == STATUS_BAD_DEVICE_TYPE && pipe_shm_flush( handle ))
+    {
+        ret = STATUS_SUCCESS;
+        io->u.Status    = ret;
+        io->Information = 0;
+    }
     else if (ret != STATUS_ACCESS_DENIED)
     {
         struct async_irp *async;
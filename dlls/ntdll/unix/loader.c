@@ -35,9 +35,14 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
 #include <sys/wait.h>
+#ifdef HAVE_SYS_UN_H
+#include <sys/un.h>
+#endif
 #include <unistd.h>
 #include <dlfcn.h>
+#include <poll.h>
 #ifdef HAVE_PWD_H
 # include <pwd.h>
 #endif
@@ -775,6 +780,511 @@ static NTSTATUS loader_exec( const char * HOSTPTR loader, char * HOSTPTR * HOSTP
 }
 
 
+/* zygote support, enabled with WINEZYGOTE=1
+ *
+ * The zygote is a loader process that stops before any per-process initialization
+ * and forks a new process for each request; the child receives the command line,
+ * environment and file descriptors of the process being created and continues the
+ * normal startup from there, saving the exec and dynamic linking of the loader and ntdll.
+ * Requests are refused, and the process is exec'ed as usual, when its resource limits or
+ * dynamic linker variables differ from the ones the zygote was started with.
+ * The zygote exits along with the server that was running when it started.
+ */
+
+#define ZYGOTE_IDLE_TIMEOUT  60000  /* ms */
+#define ZYGOTE_SERVER_CHECK  1000   /* ms */
+#define ZYGOTE_FD_COUNT     5      /* stdin, stdout, stderr, server socket, current directory */
+
+/* resource limits that the new process would inherit through exec */
+static const int zygote_limits[] =
+{
+    RLIMIT_CPU,
+    RLIMIT_FSIZE,
+    RLIMIT_DATA,
+    RLIMIT_STACK,
+    RLIMIT_CORE,
+#ifdef RLIMIT_NOFILE
+    RLIMIT_NOFILE,
+#endif
+#ifdef RLIMIT_AS
+    RLIMIT_AS,
+#endif
+#ifdef RLIMIT_MEMLOCK
+    RLIMIT_MEMLOCK,
+#endif
+#ifdef RLIMIT_NPROC
+    RLIMIT_NPROC,
+#endif
+};
+
+struct zygote_request
+{
+    unsigned int  version;    /* server protocol version of the requesting process */
+    unsigned int  argv_size;  /* size of the argv strings following the request */
+    unsigned int  env_size;   /* size of the environment strings following the argv */
+    unsigned int  umask;      /* file mode creation mask of the new process */
+    struct rlimit limits[ARRAY_SIZE(zygote_limits)];  /* resource limits of the requesting process */
+};
+
+/* the socket name contains the identity of ntdll.so, so that a zygote never
+ * serves a process that would have exec'ed a different build */
+static char * HOSTPTR get_zygote_path(void)
+{
+    const char * HOSTPTR dir = get_server_dir();
+    char * HOSTPTR path;
+    Dl_info info;
+    struct stat st;
+
+    if (!dir || !dladdr( get_zygote_path, &info ) || stat( info.dli_fname, &st ) == -1) return NULL;
+    if (!(path = malloc( strlen(dir) + sizeof("/zygote-0000") + 3 * 17 ))) return NULL;
+    sprintf( path, "%s/zygote-%04x-%llx-%llx-%llx", dir, current_machine, (unsigned long long)st.st_dev,
+             (unsigned long long)st.st_ino, (unsigned long long)st.st_mtime );
+    return path;
+}
+
+static char * HOSTPTR * HOSTPTR get_environ(void)
+{
+#ifdef __APPLE__
+    return *_NSGetEnviron();
+#else
+    return environ;
+#endif
+}
+
+/* check if an environment variable is used by the dynamic linker when exec'ing the loader */
+static BOOL is_exec_env_var( const char * HOSTPTR str )
+{
+    return !strncmp( str, "LD_", 3 ) || !strncmp( str, "DYLD_", 5 ) || !strncmp( str, "GLIBC_TUNABLES=", 15 );
+}
+
+/* check that the exec related variables of the new process environment are the same as ours */
+static BOOL check_zygote_env( const char * HOSTPTR env, const char * HOSTPTR end )
+{
+    char * HOSTPTR * HOSTPTR own_env = get_environ();
+    int i, count = 0;
+
+    for (; env < end; env += strlen( env ) + 1)
+    {
+        if (!is_exec_env_var( env )) continue;
+        for (i = 0; own_env[i]; i++) if (!strcmp( own_env[i], env )) break;
+        if (!own_env[i]) return FALSE;
+        count++;
+    }
+    for (i = 0; own_env[i]; i++) if (is_exec_env_var( own_env[i] )) count--;
+    return !count;
+}
+
+/* check that the new process has the same resource limits as ours */
+static BOOL check_zygote_limits( const struct rlimit *limits )
+{
+    struct rlimit rlimit;
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(zygote_limits); i++)
+    {
+        if (getrlimit( zygote_limits[i], &rlimit ) == -1) return FALSE;
+        if (rlimit.rlim_cur != limits[i].rlim_cur || rlimit.rlim_max != limits[i].rlim_max) return FALSE;
+    }
+    return TRUE;
+}
+
+/* return the pid of the server holding the server directory lock, 0 if none, -1 if locks are not supported */
+static pid_t get_zygote_server_pid(void)
+{
+    const char * HOSTPTR dir = get_server_dir();
+    char * HOSTPTR path;
+    struct flock fl;
+    int fd;
+
+    if (!dir || !(path = malloc( strlen(dir) + sizeof("/lock") ))) return 0;
+    strcpy( path, dir );
+    strcat( path, "/lock" );
+    fd = open( path, O_WRONLY );
+    free( path );
+    if (fd == -1) return 0;
+
+    fl.l_type   = F_WRLCK;
+    fl.l_whence = SEEK_SET;
+    fl.l_start  = 0;
+    fl.l_len    = 1;
+    if (fcntl( fd, F_GETLK, &fl ) == -1) fl.l_pid = -1;
+    else if (fl.l_type != F_WRLCK) fl.l_pid = 0;
+    close( fd );
+    return fl.l_pid;
+}
+
+static int init_zygote_addr( struct sockaddr_un *addr, const char * HOSTPTR path )
+{
+    if (strlen( path ) >= sizeof(addr->sun_path)) return 0;
+    memset( addr, 0, sizeof(*addr) );
+    addr->sun_family = AF_UNIX;
+    strcpy( addr->sun_path, path );
+    return 1;
+}
+
+static int connect_zygote( const char * HOSTPTR path )
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if (!init_zygote_addr( &addr, path )) return -1;
+    if ((fd = socket( AF_UNIX, SOCK_STREAM, 0 )) == -1) return -1;
+    if (connect( fd, (struct sockaddr *)&addr, sizeof(addr) ) == -1)
+    {
+        close( fd );
+        return -1;
+    }
+    fcntl( fd, F_SETFD, FD_CLOEXEC );
+    return fd;
+}
+
+static int listen_zygote( const char * HOSTPTR path )
+{
+    struct sockaddr_un addr;
+    int fd, other;
+
+    if (!init_zygote_addr( &addr, path )) return -1;
+    if ((fd = socket( AF_UNIX, SOCK_STREAM, 0 )) == -1) return -1;
+    if (bind( fd, (struct sockaddr *)&addr, sizeof(addr) ) == -1)
+    {
+        if (errno != EADDRINUSE) goto failed;
+        if ((other = connect_zygote( path )) != -1)  /* another zygote is already running */
+        {
+            close( other );
+            goto failed;
+        }
+        unlink( path );  /* stale socket */
+        if (bind( fd, (struct sockaddr *)&addr, sizeof(addr) ) == -1) goto failed;
+    }
+    if (listen( fd, 16 ) == -1)
+    {
+        unlink( path );
+        goto failed;
+    }
+    fcntl( fd, F_SETFD, FD_CLOEXEC );
+    return fd;
+
+failed:
+    close( fd );
+    return -1;
+}
+
+static BOOL read_zygote_data( int fd, char * HOSTPTR data, size_t size )
+{
+    ssize_t ret;
+
+    while (size)
+    {
+        if ((ret = read( fd, data, size )) > 0)
+        {
+            data += ret;
+            size -= ret;
+        }
+        else if (!ret || errno != EINTR) return FALSE;
+    }
+    return TRUE;
+}
+
+static BOOL write_zygote_data( int fd, const char * HOSTPTR data, size_t size )
+{
+    ssize_t ret;
+
+    while (size)
+    {
+        if ((ret = write( fd, data, size )) > 0)
+        {
+            data += ret;
+            size -= ret;
+        }
+        else if (!ret || errno != EINTR) return FALSE;
+    }
+    return TRUE;
+}
+
+/* start a detached zygote process, it will be used for the next process creation */
+static void start_zygote( const char * HOSTPTR path, int socketfd )
+{
+    char * HOSTPTR argv[3] = { NULL, NULL, NULL };
+    char * HOSTPTR zygote_env;
+    pid_t pid;
+    int fd;
+
+    if (!(pid = fork()))
+    {
+        if (!fork())
+        {
+            setsid();
+            if ((fd = open( "/dev/null", O_RDWR )) != -1)
+            {
+                dup2( fd, 0 );
+                dup2( fd, 1 );
+                dup2( fd, 2 );
+                if (fd > 2) close( fd );
+            }
+            close( socketfd );
+            chdir( "/" );
+            signal( SIGPIPE, SIG_DFL );
+            unsetenv( "WINESERVERSOCKET" );
+            unsetenv( "WINEPRELOADRESERVE" );
+            unsetenv( "WINESPAWNSTART" );
+            if (!(zygote_env = malloc( sizeof("WINEZYGOTEPATH=") + strlen(path) ))) _exit(1);
+            strcpy( zygote_env, "WINEZYGOTEPATH=" );
+            strcat( zygote_env, path );
+            putenv( zygote_env );
+            setenv( "WINELOADERNOEXEC", "1", 1 );
+            loader_exec( argv0, argv, current_machine );
+            _exit(1);
+        }
+        _exit(0);
+    }
+    if (pid != -1) waitpid( pid, NULL, 0 );
+}
+
+/***********************************************************************
+ *           zygote_spawn
+ *
+ * Pass the process being exec'ed to the zygote. argv is in exec_wineloader() format.
+ */
+static BOOL zygote_spawn( char * HOSTPTR * HOSTPTR argv, int socketfd )
+{
+    char * HOSTPTR * HOSTPTR env = get_environ();
+    char cmsg_buffer[CMSG_SPACE( ZYGOTE_FD_COUNT * sizeof(int) )];
+    const char * HOSTPTR enabled = getenv( "WINEZYGOTE" );
+    struct zygote_request req;
+    struct msghdr msghdr;
+    struct cmsghdr *cmsg;
+    struct iovec vec;
+    char * HOSTPTR path, * HOSTPTR data = NULL, * HOSTPTR p;
+    int i, fd, cwd = -1, fds[ZYGOTE_FD_COUNT];
+    pid_t pid;
+    BOOL ret = FALSE;
+
+    if (!enabled || !atoi( enabled )) return FALSE;
+    /* the child can't share our session, so leave processes using a terminal alone */
+    if (isatty( 0 ) || isatty( 1 ) || isatty( 2 )) return FALSE;
+    if (!(path = get_zygote_path())) return FALSE;
+    fd = connect_zygote( path );
+    if (fd == -1) start_zygote( path, socketfd );
+    free( path );
+    if (fd == -1) return FALSE;
+
+    req.version = SERVER_PROTOCOL_VERSION;
+    req.argv_size = req.env_size = 0;
+    req.umask = umask( 0 );
+    umask( req.umask );
+    memset( req.limits, 0, sizeof(req.limits) );
+    for (i = 0; i < ARRAY_SIZE(zygote_limits); i++) getrlimit( zygote_limits[i], &req.limits[i] );
+    for (i = 2; argv[i]; i++) req.argv_size += strlen( argv[i] ) + 1;
+    for (i = 0; env[i]; i++) req.env_size += strlen( env[i] ) + 1;
+
+    if (!(p = data = malloc( req.argv_size + req.env_size ))) goto done;
+    for (i = 2; argv[i]; i++) p += strlen( strcpy( p, argv[i] )) + 1;
+    for (i = 0; env[i]; i++) p += strlen( strcpy( p, env[i] )) + 1;
+
+    if ((cwd = open( ".", O_RDONLY )) == -1) goto done;
+    fds[0] = 0;
+    fds[1] = 1;
+    fds[2] = 2;
+    fds[3] = socketfd;
+    fds[4] = cwd;
+
+    vec.iov_base = (void *)&req;
+    vec.iov_len  = sizeof(req);
+
+    memset( &msghdr, 0, sizeof(msghdr) );
+    msghdr.msg_iov        = &vec;
+    msghdr.msg_iovlen     = 1;
+    msghdr.msg_control    = cmsg_buffer;
+    msghdr.msg_controllen = sizeof(cmsg_buffer);
+
+    cmsg = CMSG_FIRSTHDR( &msghdr );
+    cmsg->cmsg_len   = CMSG_LEN( sizeof(fds) );
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    memcpy( CMSG_DATA(cmsg), fds, sizeof(fds) );
+
+    /* the zygote child replies with its pid once it has taken over */
+    if (sendmsg( fd, &msghdr, 0 ) == sizeof(req) &&
+        write_zygote_data( fd, data, req.argv_size + req.env_size ) &&
+        read_zygote_data( fd, (char *)&pid, sizeof(pid) ))
+        ret = TRUE;
+
+done:
+    if (cwd != -1) close( cwd );
+    close( fd );
+    free( data );
+    return ret;
+}
+
+/* receive a request and its data; it's refused if exec'ing the loader would start the process differently */
+static char * HOSTPTR receive_zygote_request( int fd, struct zygote_request *req, int fds[ZYGOTE_FD_COUNT] )
+{
+    char cmsg_buffer[CMSG_SPACE( ZYGOTE_FD_COUNT * sizeof(int) )];
+    struct msghdr msghdr;
+    struct cmsghdr *cmsg;
+    struct iovec vec;
+    char * HOSTPTR data = NULL;
+    size_t size;
+    ssize_t ret;
+    int i, count = 0;
+
+    vec.iov_base = (void *)req;
+    vec.iov_len  = sizeof(*req);
+
+    memset( &msghdr, 0, sizeof(msghdr) );
+    msghdr.msg_iov        = &vec;
+    msghdr.msg_iovlen     = 1;
+    msghdr.msg_control    = cmsg_buffer;
+    msghdr.msg_controllen = sizeof(cmsg_buffer);
+
+    while ((ret = recvmsg( fd, &msghdr, 0 )) == -1 && errno == EINTR);
+
+    for (cmsg = CMSG_FIRSTHDR( &msghdr ); cmsg; cmsg = CMSG_NXTHDR( &msghdr, cmsg ))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+        for (i = 0; i < (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int); i++)
+        {
+            int unix_fd;
+
+            memcpy( &unix_fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int) );
+            if (count < ZYGOTE_FD_COUNT) fds[count++] = unix_fd;
+            else close( unix_fd );
+        }
+    }
+
+    if (ret != sizeof(*req) || count != ZYGOTE_FD_COUNT || req->version != SERVER_PROTOCOL_VERSION) goto failed;
+    size = req->argv_size + req->env_size;
+    if (!req->argv_size || !(data = malloc( size ))) goto failed;
+    if (!read_zygote_data( fd, data, size ) || data[size - 1]) goto failed;
+    if (!check_zygote_env( data + req->argv_size, data + size ) || !check_zygote_limits( req->limits ))
+        goto failed;
+    return data;
+
+failed:
+    free( data );
+    for (i = 0; i < count; i++) close( fds[i] );
+    return NULL;
+}
+
+/* set up the process forked from the zygote for the request it was created for */
+static void init_zygote_child( int fd, const struct zygote_request *req, char * HOSTPTR data,
+                               int fds[ZYGOTE_FD_COUNT], int *argc, char * HOSTPTR * HOSTPTR *argv,
+                               char * HOSTPTR * HOSTPTR *envp )
+{
+    size_t size = req->argv_size + req->env_size;
+    char * HOSTPTR * HOSTPTR new_argv, * HOSTPTR * HOSTPTR new_env;
+    char * HOSTPTR p, * HOSTPTR end, * HOSTPTR socket_env;
+    int i, argv_count = 0, env_count = 0;
+    pid_t pid = getpid();
+
+    signal( SIGCHLD, SIG_DFL );
+    setsid();
+    dbg_reset_trace();
+
+    for (p = data, end = data + req->argv_size; p < end; p += strlen(p) + 1) argv_count++;
+    for (end = data + size; p < end; p += strlen(p) + 1) env_count++;
+
+    /* argv[0] and argv[1] are reserved for exec_wineloader() */
+    if (!(new_argv = malloc( (argv_count + 3) * sizeof(*new_argv) ))) _exit(1);
+    if (!(new_env = malloc( (env_count + 1) * sizeof(*new_env) ))) _exit(1);
+    if (!(socket_env = malloc( sizeof("WINESERVERSOCKET=") + 12 ))) _exit(1);
+
+    new_argv[0] = NULL;
+    new_argv[1] = argv0;
+    for (i = 0, p = data; i < argv_count; i++, p += strlen(p) + 1) new_argv[i + 2] = p;
+    new_argv[i + 2] = NULL;
+    for (i = 0; i < env_count; i++, p += strlen(p) + 1) new_env[i] = p;
+    new_env[i] = NULL;
+
+    for (i = 0; i < 3; i++)
+    {
+        dup2( fds[i], i );
+        close( fds[i] );
+    }
+    fchdir( fds[4] );
+    close( fds[4] );
+    umask( req->umask );
+
+#ifdef __APPLE__
+    *_NSGetEnviron() = new_env;
+#else
+    environ = new_env;
+#endif
+    sprintf( socket_env, "WINESERVERSOCKET=%u", fds[3] );
+    putenv( socket_env );
+
+    write_zygote_data( fd, (char *)&pid, sizeof(pid) );
+    close( fd );
+
+    init_paths( new_argv + 1 );
+
+    /* fall back to a normal exec if the exe range is not available in our address space */
+    if (!virtual_reserve_exe_range())
+    {
+        loader_exec( argv0, new_argv, current_machine );
+        _exit(1);
+    }
+
+    *argc = argv_count + 1;
+    *argv = new_argv + 1;
+    *envp = new_env;
+}
+
+/***********************************************************************
+ *           zygote_main
+ *
+ * Main loop of the zygote process. Only returns in the forked children.
+ */
+static void zygote_main( const char * HOSTPTR path, int *argc, char * HOSTPTR * HOSTPTR *argv,
+                         char * HOSTPTR * HOSTPTR *envp )
+{
+    struct zygote_request req;
+    struct pollfd pollfd;
+    char * HOSTPTR own_path, * HOSTPTR data;
+    int fd, conn, i, ret, idle = 0, fds[ZYGOTE_FD_COUNT];
+    pid_t pid, server_pid;
+
+    /* ntdll.so may have been replaced since our creator computed the path */
+    if (!(own_path = get_zygote_path()) || strcmp( own_path, path )) exit(0);
+    free( own_path );
+
+    /* we don't connect to the server, so watch its lock to exit along with it */
+    if (!(server_pid = get_zygote_server_pid())) exit(0);
+
+    if ((fd = listen_zygote( path )) == -1) exit(0);
+    signal( SIGCHLD, SIG_IGN );  /* our children are reparented to us, don't leave zombies */
+
+    pollfd.fd = fd;
+    pollfd.events = POLLIN;
+    while (idle < ZYGOTE_IDLE_TIMEOUT && get_zygote_server_pid() == server_pid)
+    {
+        if ((ret = poll( &pollfd, 1, ZYGOTE_SERVER_CHECK )) == -1 && errno == EINTR) continue;
+        if (ret < 0) break;
+        if (!ret)
+        {
+            idle += ZYGOTE_SERVER_CHECK;
+            continue;
+        }
+        idle = 0;
+        if ((conn = accept( fd, NULL, NULL )) == -1) continue;
+
+        if ((data = receive_zygote_request( conn, &req, fds )))
+        {
+            if (!(pid = fork()))
+            {
+                close( fd );
+                init_zygote_child( conn, &req, data, fds, argc, argv, envp );
+                return;
+            }
+            for (i = 0; i < ZYGOTE_FD_COUNT; i++) close( fds[i] );
+            free( data );
+        }
+        close( conn );
+    }
+    unlink( path );
+    exit(0);
+}
+
 /***********************************************************************
  *           exec_wineloader
  *
@@ -787,7 +1297,7 @@ NTSTATUS exec_wineloader( char * HOSTPTR * HOSTPTR argv, int socketfd, const pe_
     ULONGLONG res_end = pe_info->base + pe_info->map_size;
     const char * HOSTPTR loader = argv0;
     const char * HOSTPTR loader_env = getenv( "WINELOADER" );
-    char preloader_reserve[64], socket_env[64];
+    char preloader_reserve[64], socket_env[64], spawn_start[64];
     BOOL is_child_64bit;
 
     if (pe_info->image_flags & IMAGE_FLAGS_WineFakeDll) res_start = res_end = 0;
@@ -824,7 +1334,14 @@ NTSTATUS exec_wineloader( char * HOSTPTR * HOSTPTR argv, int socketfd, const pe_
         else loader = is_child_64bit ? "wine64" : wine_needs_32on64() ? "wine32on64" : "wine";
     }
 
-    signal( SIGPIPE, SIG_DFL );
+    if (getenv( "WINESTARTUPTRACE" ))
+    {
+        LARGE_INTEGER counter;
+
+        NtQueryPerformanceCounter( &counter, NULL );
+        sprintf( spawn_start, "WINESPAWNSTART=%x%08x", (ULONG)(counter.QuadPart >> 32), (ULONG)counter.QuadPart );
+        putenv( spawn_start );
+    }
 
     sprintf( socket_env, "WINESERVERSOCKET=%u", socketfd );
     sprintf( preloader_reserve, "WINEPRELOADRESERVE=%x%08x-%x%08x",
@@ -833,6 +1350,9 @@ NTSTATUS exec_wineloader( char * HOSTPTR * HOSTPTR argv, int socketfd, const pe_
     putenv( preloader_reserve );
     putenv( socket_env );
 
+    if (loader == argv0 && zygote_spawn( argv, socketfd )) _exit(0);
+
+    signal( SIGPIPE, SIG_DFL );
     return loader_exec( loader, argv, machine );
 }
 
@@ -895,6 +1415,7 @@ void start_server( BOOL debug )
 
     if (!started)
     {
+        LONGLONG start = startup_trace_start();
         int status;
         int pid = fork();
         if (pid == -1) fatal_error( "fork: %s", strerror(errno) );
@@ -906,6 +1427,7 @@ void start_server( BOOL debug )
             fatal_error( "could not exec wineserver\n" );
         }
         waitpid( pid, &status, 0 );
+        startup_trace( "start_server", NULL, start, 0 );
         status = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
         if (status == 2) return;  /* server lock held by someone else, will retry later */
         if (status) exit(status);  /* server failed */
@@ -2092,6 +2614,7 @@ static void load_ntdll(void)
     void *module;
     SIZE_T size = 0;
     char * HOSTPTR name;
+    LONGLONG start;
 
     init_unicode_string( &str, path );
     InitializeObjectAttributes( &attr, &str, 0, 0, NULL );
@@ -2108,7 +2631,9 @@ static void load_ntdll(void)
     if (status == STATUS_IMAGE_NOT_AT_BASE) relocate_ntdll( module );
     else if (status) fatal_error( "failed to load %s error %x\n", name, status );
     free( name );
+    start = startup_trace_start();
     load_ntdll_functions( module );
+    startup_trace( "load_ntdll_functions", NULL, start, 0 );
     ntdll_module = module;
 }
 
@@ -2279,6 +2804,7 @@ static struct unix_funcs unix_funcs =
     unwind_builtin_dll,
     RtlGetSystemTimePrecise,
     dlsym_unix_ntdll,
+    startup_trace,
 #ifdef __aarch64__
     NtCurrentTeb,
 #endif
@@ -2334,6 +2860,7 @@ static void start_main_thread(void)
 {
     SYSTEM_SERVICE_TABLE syscall_table = { (ULONG_PTR *)syscalls, NULL, ARRAY_SIZE(syscalls), syscall_args };
     NTSTATUS status;
+    LONGLONG start = startup_trace_start();
     TEB *teb = virtual_alloc_first_teb();
 
     signal_init_threading();
@@ -2343,12 +2870,19 @@ static void start_main_thread(void)
 #endif
     signal_init_thread( teb );
     dbg_init();
+    startup_trace( "thread_init", NULL, start, 0 );
+    start = startup_trace_start();
     startup_info_size = server_init_process();
+    startup_trace( "server_init_process", NULL, start, 0 );
     virtual_map_user_shared_data();
     init_cpu_info();
     init_files();
+    start = startup_trace_start();
     load_libwine();
+    startup_trace( "load_libwine", NULL, start, 0 );
+    start = startup_trace_start();
     init_startup_info();
+    startup_trace( "init_startup_info", NULL, start, 0 );
     if (p___wine_main_argc) *p___wine_main_argc = main_argc;
     if (p___wine_main_argv) *p___wine_main_argv = main_argv;
     if (p___wine_main_wargv) *p___wine_main_wargv = main_wargv;
@@ -2356,10 +2890,13 @@ static void start_main_thread(void)
     set_load_order_app_name( main_wargv[0] );
     init_thread_stack( teb, 0, 0, 0 );
     NtCreateKeyedEvent( &keyed_event, GENERIC_READ | GENERIC_WRITE, NULL, 0 );
+    start = startup_trace_start();
     load_ntdll();
+    startup_trace( "load_ntdll", NULL, start, 0 );
     if (main_image_info.Machine != current_machine) load_wow64_ntdll( main_image_info.Machine );
     load_apiset_dll();
     ntdll_init_syscalls( 0, &syscall_table, p__wine_syscall_dispatcher );
+    if (!startup_trace_start()) unix_funcs.startup_trace = NULL;
     status = p__wine_set_unix_funcs( NTDLL_UNIXLIB_VERSION, &unix_funcs );
     if (status == STATUS_REVISION_MISMATCH)
     {
@@ -2384,7 +2921,9 @@ static void start_main_thread(void)
 
     while (pRtlFindClearBitsAndSet(teb->Peb->TlsBitmap, 1, 1) != ~0U);
 #endif
+    start = startup_trace_start();
     server_init_process_done();
+    startup_trace( "server_init_process_done", NULL, start, 0 );
 }
 
 #ifdef __ANDROID__
@@ -2686,6 +3225,9 @@ void __wine_main_real( int argc, char * HOSTPTR * HOSTPTR argv, char * HOSTPTR *
 void __wine_main( int argc, char * HOSTPTR * HOSTPTR argv, char * HOSTPTR * HOSTPTR envp )
 #endif
 {
+    const char * HOSTPTR zygote, * HOSTPTR spawn_start;
+    LONGLONG start;
+
     init_paths( argv );
 
     if (!getenv( "WINELOADERNOEXEC" ))  /* first time around */
@@ -2710,7 +3252,17 @@ void __wine_main( int argc, char * HOSTPTR * HOSTPTR argv, char * HOSTPTR * HOST
     set_max_limit( RLIMIT_AS );
 #endif
 
+    if ((zygote = getenv( "WINEZYGOTEPATH" ))) zygote_main( zygote, &argc, &argv, &envp );
+
+    start = startup_trace_start();
+    if ((spawn_start = getenv( "WINESPAWNSTART" )))
+    {
+        /* time from the parent's exec_wineloader() until we get here */
+        startup_trace( "spawn", NULL, strtoull( spawn_start, NULL, 16 ), 0 );
+        unsetenv( "WINESPAWNSTART" );
+    }
     virtual_init();
+    startup_trace( "virtual_init", NULL, start, 0 );
     init_environment( argc, argv, envp );
 
 #if defined(__APPLE__) && !defined(__i386_on_x86_64__)
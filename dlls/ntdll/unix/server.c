@@ -986,33 +986,58 @@ static inline NTSTATUS get_cached_fd( HANDLE handle, int *fd, enum server_fd_typ
 
 /***********************************************************************
  *           remove_fd_from_cache
+ *
+ * Return the cached unix fd of a handle, and whether it was opened with FILE_DELETE_ON_CLOSE.
  */
-static int remove_fd_from_cache( HANDLE handle )
+static int remove_fd_from_cache( HANDLE handle, BOOL *delete_on_close )
 {
     unsigned int entry, idx = handle_to_index( handle, &entry );
     int fd = -1;
 
+    *delete_on_close = FALSE;
     if (entry < FD_CACHE_ENTRIES && fd_cache[entry])
     {
         union fd_cache_entry cache;
         cache.data = interlocked_xchg64( &fd_cache[entry][idx].data, 0 );
         if (cache.s.type != FD_TYPE_INVALID) fd = cache.s.fd - 1;
+        if (cache.s.type == FD_TYPE_PIPE) release_pipe_shm( fd );
+        if (cache.s.type == FD_TYPE_FILE || cache.s.type == FD_TYPE_DIR)
+        {
+            remove_file_info_cache( handle );
+            *delete_on_close = (cache.s.options & FILE_DELETE_ON_CLOSE) != 0;
+        }
     }
 
     return fd;
 }
 
 
+/***********************************************************************
+ *           server_get_cached_unix_fd
+ *
+ * Same as server_get_unix_fd, but only succeeds if the fd is already cached,
+ * so that it never needs a server round trip. The returned fd must not be closed.
+ */
+int server_get_cached_unix_fd( HANDLE handle, int *unix_fd, enum server_fd_type *type )
+{
+    *unix_fd = -1;
+    return get_cached_fd( handle, unix_fd, type, NULL, NULL );
+}
+
+
 /***********************************************************************
  *           server_get_unix_fd
  *
  * The returned unix_fd should be closed iff needs_close is non-zero.
+ * Pipe ends only have an fd for their shared memory rings, so they
+ * are reported as STATUS_BAD_DEVICE_TYPE with type set to FD_TYPE_PIPE.
  */
 int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
                         int *needs_close, enum server_fd_type *type, unsigned int *options )
 {
     sigset_t sigset;
     obj_handle_t fd_handle;
+    enum server_fd_type fd_type = FD_TYPE_INVALID;
     int ret, fd = -1;
     unsigned int access = 0;
 
@@ -1020,11 +1045,11 @@ int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
     *needs_close = 0;
     wanted_access &= FILE_READ_DATA | FILE_WRITE_DATA | FILE_APPEND_DATA;
 
-    ret = get_cached_fd( handle, &fd, type, &access, options );
+    ret = get_cached_fd( handle, &fd, &fd_type, &access, options );
     if (ret != STATUS_INVALID_HANDLE) goto done;
 
     server_enter_uninterrupted_section( &fd_cache_mutex, &sigset );
-    ret = get_cached_fd( handle, &fd, type, &access, options );
+    ret = get_cached_fd( handle, &fd, &fd_type, &access, options );
     if (ret == STATUS_INVALID_HANDLE)
     {
         SERVER_START_REQ( get_handle_fd )
@@ -1032,7 +1057,7 @@ int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
             req->handle = wine_server_obj_handle( handle );
             if (!(ret = wine_server_call( req )))
             {
-                if (type) *type = reply->type;
+                fd_type = reply->type;
                 if (options) *options = reply->options;
                 access = reply->access;
                 if ((fd = receive_fd( &fd_handle )) != -1)
@@ -1059,7 +1084,14 @@ done:
         ret = STATUS_ACCESS_DENIED;
         if (*needs_close) close( fd );
     }
+    else if (!ret && fd_type == FD_TYPE_PIPE)
+    {
+        ret = STATUS_BAD_DEVICE_TYPE;
+        if (*needs_close) close( fd );
+        *needs_close = 0;
+    }
     if (!ret) *unix_fd = fd;
+    if ((!ret || fd_type == FD_TYPE_PIPE) && type) *type = fd_type;
     return ret;
 }
 
@@ -1318,6 +1350,24 @@ static int server_connect(void)
 }
 
 
+/***********************************************************************
+ *           get_server_dir
+ *
+ * Return the server directory, also in processes that didn't connect to the server themselves.
+ */
+const char * HOSTPTR get_server_dir(void)
+{
+    if (!server_dir)
+    {
+        struct stat st;
+
+        if (stat( config_dir, &st ) == -1) return NULL;
+        server_dir = init_server_dir( st.st_dev, st.st_ino );
+    }
+    return server_dir;
+}
+
+
 #ifdef __APPLE__
 #include <mach/mach.h>
 #include <mach/mach_error.h>
@@ -1337,13 +1387,7 @@ static void send_server_task_port(void)
 
     if (task_get_bootstrap_port(mach_task_self(), &bootstrap_port) != KERN_SUCCESS) return;
 
-    if (!server_dir)
-    {
-        struct stat st;
-        stat( config_dir, &st );
-        server_dir = init_server_dir( st.st_dev, st.st_ino );
-    }
-    kret = bootstrap_look_up(bootstrap_port, server_dir, &wineserver_port);
+    kret = bootstrap_look_up(bootstrap_port, get_server_dir(), &wineserver_port);
     if (kret != KERN_SUCCESS)
         fatal_error( "cannot find the server port: 0x%08x\n", kret );
 
@@ -1429,6 +1473,7 @@ static int init_thread_pipe(void)
  */
 void process_exit_wrapper( int status )
 {
+    startup_trace_write();
     close( fd_socket );
     exit( status );
 }
@@ -1647,6 +1692,7 @@ NTSTATUS WINAPI NtDuplicateObject( HANDLE source_process, HANDLE source, HANDLE
 {
     sigset_t sigset;
     NTSTATUS ret;
+    BOOL delete_on_close;
     int fd = -1;
 
     if (dest) *dest = 0;
@@ -1677,7 +1723,7 @@ NTSTATUS WINAPI NtDuplicateObject( HANDLE source_process, HANDLE source, HANDLE
     /* always remove the cached fd; if the server request fails we'll just
      * retrieve it again */
     if (options & DUPLICATE_CLOSE_SOURCE)
-        fd = remove_fd_from_cache( source );
+        fd = remove_fd_from_cache( source, &delete_on_close );
 
     SERVER_START_REQ( dup_handle )
     {
@@ -1728,13 +1774,14 @@ NTSTATUS WINAPI NtClose( HANDLE handle )
     sigset_t sigset;
     HANDLE port;
     NTSTATUS ret;
+    BOOL delete_on_close;
     int fd;
 
     server_enter_uninterrupted_section( &fd_cache_mutex, &sigset );
 
     /* always remove the cached fd; if the server request fails we'll just
      * retrieve it again */
-    fd = remove_fd_from_cache( handle );
+    fd = remove_fd_from_cache( handle, &delete_on_close );
 
     SERVER_START_REQ( close_handle )
     {
@@ -1746,6 +1793,8 @@ NTSTATUS WINAPI NtClose( HANDLE handle )
     server_leave_uninterrupted_section( &fd_cache_mutex, &sigset );
 
     if (fd != -1) close( fd );
+    /* the file may be gone now, including for the other handles that cached its metadata */
+    if (delete_on_close) invalidate_file_info_cache();
 
     if (ret != STATUS_INVALID_HANDLE || !handle) return ret;
     if (!peb->BeingDebugged) return ret;
@@ -24,9 +24,11 @@
 
 #include "config.h"
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <poll.h>
 #include <unistd.h>
 #ifdef HAVE_IFADDRS_H
 # include <ifaddrs.h>
@@ -41,6 +43,12 @@
 #ifdef HAVE_NETINET_TCP_H
 # include <netinet/tcp.h>
 #endif
+#ifdef HAVE_NETINET_UDP_H
+# include <netinet/udp.h>
+#endif
+#ifdef linux
+# include <sys/sendfile.h>
+#endif
 
 #ifdef HAVE_NETIPX_IPX_H
 # include <netipx/ipx.h>
@@ -89,6 +97,9 @@
 #define IP_UNICAST_IF 50
 #endif
 
+/* maximum UDP payload; the largest size a coalesced receive can have */
+#define MAX_UDP_COALESCED_SIZE 65527
+
 WINE_DEFAULT_DEBUG_CHANNEL(winsock);
 
 #define u64_to_user_ptr(u) ((void *)(uintptr_t)(u))
@@ -147,6 +158,7 @@ struct async_transmit_ioctl
     unsigned int head_len;
     unsigned int tail_len;
     LARGE_INTEGER offset;
+    BOOL use_sendfile;          /* send file data directly with sendfile() */
 };
 
 static NTSTATUS sock_errno_to_status( int err )
@@ -453,6 +465,26 @@ static int convert_control_headers(struct msghdr *hdr, WSABUF *control)
                 }
                 break;
 
+#ifdef UDP_GRO
+            case IPPROTO_UDP:
+                switch (cmsg_unix->cmsg_type)
+                {
+                    case UDP_GRO:
+                    {
+                        DWORD size = *(int *)CMSG_DATA(cmsg_unix);
+                        ptr = fill_control_message( WS_IPPROTO_UDP, WS_UDP_COALESCED_INFO, ptr, &ctlsize,
+                                                    &size, sizeof(size) );
+                        if (!ptr) goto error;
+                        break;
+                    }
+
+                    default:
+                        FIXME("Unhandled IPPROTO_UDP message header type %d\n", cmsg_unix->cmsg_type);
+                        break;
+                }
+                break;
+#endif /* UDP_GRO */
+
             case IPPROTO_IPV6:
                 switch (cmsg_unix->cmsg_type)
                 {
@@ -947,6 +979,46 @@ static ssize_t do_send( int fd, const void * HOSTPTR buffer, size_t len, int fla
     return ret;
 }
 
+#ifdef linux
+/* send the file data without copying it through our buffer; returns
+ * STATUS_NOT_SUPPORTED if the buffered path needs to be used instead */
+static NTSTATUS try_sendfile( int sock_fd, int file_fd, struct async_transmit_ioctl *async )
+{
+    while (async->file)
+    {
+        size_t count = async->file_len ? async->file_len - async->file_cursor : 0x40000000;
+        off_t offset = async->offset.QuadPart;
+        ssize_t ret;
+
+        TRACE( "sending %zu bytes of file data\n", count );
+        if (async->offset.QuadPart == FILE_USE_FILE_POINTER_POSITION)
+            ret = sendfile( sock_fd, file_fd, NULL, count );
+        else
+            ret = sendfile( sock_fd, file_fd, &offset, count );
+
+        if (ret < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno == EINVAL || errno == ENOSYS)
+            {
+                TRACE( "sendfile not supported for this file, falling back to read/send\n" );
+                async->use_sendfile = FALSE;
+                return STATUS_NOT_SUPPORTED;
+            }
+            return sock_errno_to_status( errno );
+        }
+        TRACE( "sendfile returned %zd\n", ret );
+
+        async->file_cursor += ret;
+        if (async->offset.QuadPart != FILE_USE_FILE_POINTER_POSITION)
+            async->offset.QuadPart += ret;
+        if (!ret || (async->file_len && async->file_cursor == async->file_len))
+            async->file = NULL;
+    }
+    return STATUS_SUCCESS;
+}
+#endif
+
 static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_ioctl *async )
 {
     ssize_t ret;
@@ -972,6 +1044,14 @@ static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_io
         async->file_cursor += ret;
     }
 
+#ifdef linux
+    if (async->file && async->use_sendfile && async->buffer_cursor == async->read_len)
+    {
+        NTSTATUS status = try_sendfile( sock_fd, file_fd, async );
+        if (status != STATUS_SUCCESS && status != STATUS_NOT_SUPPORTED) return status;
+    }
+#endif
+
     if (async->file && async->buffer_cursor == async->read_len)
     {
         unsigned int read_size = async->buffer_size;
@@ -1096,6 +1176,7 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
     async->tail = ADDRSPACECAST(void * HOSTPTR, params->tail_ptr);
     async->tail_len = params->tail_len;
     async->offset = params->offset;
+    async->use_sendfile = TRUE;
 
     SERVER_START_REQ( send_socket )
     {
@@ -1182,6 +1263,182 @@ static int get_sock_type( HANDLE handle )
 }
 
 
+/* Try to satisfy an AFD poll request from the client side, without going
+ * through the server. This is only done when the result can't depend on
+ * state tracked by the server: all the sockets must already have cached fds
+ * and be listening, connected, or connectionless, and no socket error may be
+ * pending. Returns STATUS_BAD_DEVICE_TYPE if the server needs to handle it.
+ *
+ * A single zero-timeout poll() is used rather than a persistent epoll set:
+ * the event mask changes with every request and several threads may poll the
+ * same sockets at once, so an epoll set would need an epoll_ctl() call per
+ * socket per request on top of the epoll_wait(). */
+static NTSTATUS try_poll_sockets( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                                  IO_STATUS_BLOCK *io, const void *in_buffer, ULONG in_size,
+                                  void *out_buffer, ULONG out_size )
+{
+    const struct afd_poll_params_64 *params = in_buffer;
+    struct afd_poll_params_64 *output;
+    struct pollfd *pollfds;
+    int *sock_flags;
+    unsigned int i, signaled = 0;
+    NTSTATUS status = STATUS_BAD_DEVICE_TYPE;
+    ULONG size;
+
+    enum { POLL_LISTENING = 1, POLL_CONNECTED = 2, POLL_STREAM = 4, POLL_OOBINLINE = 8 };
+
+    if (in_wow64_call() || sizeof(SOCKET) != sizeof(params->sockets[0].socket)) return status;
+    if (in_size < sizeof(*params) || !params->count || params->exclusive) return status;
+    size = offsetof( struct afd_poll_params_64, sockets[params->count] );
+    if (in_size < size || out_size < in_size) return status;
+
+    if (!(pollfds = malloc( params->count * (sizeof(*pollfds) + sizeof(*sock_flags)) ))) return status;
+    sock_flags = (int *)(pollfds + params->count);
+
+    for (i = 0; i < params->count; ++i)
+    {
+        HANDLE sock = wine_server_ptr_handle( params->sockets[i].socket );
+        int mask = params->sockets[i].flags, value, fd;
+        union unix_sockaddr addr;
+        socklen_t len;
+        enum server_fd_type type;
+
+        if (server_get_cached_unix_fd( sock, &fd, &type ) || type != FD_TYPE_SOCKET) goto done;
+
+        sock_flags[i] = 0;
+        len = sizeof(value);
+        if (getsockopt( fd, SOL_SOCKET, SO_TYPE, &value, &len )) goto done;
+        if (value == SOCK_STREAM)
+        {
+            sock_flags[i] |= POLL_STREAM;
+            len = sizeof(value);
+            if (!getsockopt( fd, SOL_SOCKET, SO_ACCEPTCONN, &value, &len ) && value)
+                sock_flags[i] |= POLL_LISTENING;
+        }
+        if (!(sock_flags[i] & POLL_LISTENING))
+        {
+            len = sizeof(addr);
+            if (!getpeername( fd, &addr.addr, &len )) sock_flags[i] |= POLL_CONNECTED;
+            else if (sock_flags[i] & POLL_STREAM) goto done;  /* the server knows if it's connecting */
+        }
+        if (mask & AFD_POLL_OOB)
+        {
+            len = sizeof(value);
+            if (!getsockopt( fd, SOL_SOCKET, SO_OOBINLINE, &value, &len ) && value)
+                sock_flags[i] |= POLL_OOBINLINE;
+        }
+
+        pollfds[i].fd = fd;
+        pollfds[i].events = 0;
+        pollfds[i].revents = 0;
+        if (mask & (AFD_POLL_READ | AFD_POLL_ACCEPT)) pollfds[i].events |= POLLIN;
+        if ((mask & AFD_POLL_HUP) && (sock_flags[i] & POLL_STREAM)) pollfds[i].events |= POLLIN;
+        if (mask & AFD_POLL_OOB) pollfds[i].events |= (sock_flags[i] & POLL_OOBINLINE) ? POLLIN : POLLPRI;
+        if (mask & AFD_POLL_WRITE) pollfds[i].events |= POLLOUT;
+    }
+
+    if (poll( pollfds, params->count, 0 ) < 0) goto done;
+
+    for (i = 0; i < params->count; ++i)
+    {
+        int revents = pollfds[i].revents, flags = 0;
+
+        /* the pending error must be consumed by the server */
+        if (revents & (POLLERR | POLLNVAL)) goto done;
+
+        if ((params->sockets[i].flags & AFD_POLL_HUP) && (revents & POLLIN) && (sock_flags[i] & POLL_STREAM))
+        {
+            char dummy;
+
+            if (!recv( pollfds[i].fd, &dummy, 1, MSG_PEEK ))
+            {
+                revents &= ~POLLIN;
+                revents |= POLLHUP;
+            }
+        }
+
+        if (revents & POLLIN) flags |= (sock_flags[i] & POLL_LISTENING) ? AFD_POLL_ACCEPT : AFD_POLL_READ;
+        if (revents & POLLPRI) flags |= (sock_flags[i] & POLL_OOBINLINE) ? AFD_POLL_READ : AFD_POLL_OOB;
+        if (revents & POLLOUT) flags |= AFD_POLL_WRITE;
+        if (sock_flags[i] & POLL_CONNECTED) flags |= AFD_POLL_CONNECT;
+        if (revents & POLLHUP) flags |= AFD_POLL_HUP;
+
+        /* reuse the pollfd array to store the result */
+        pollfds[i].events = flags & params->sockets[i].flags;
+        if (pollfds[i].events) ++signaled;
+    }
+
+    /* nothing to report yet; let the server wait for it */
+    if (!signaled && params->timeout) goto done;
+
+    size = offsetof( struct afd_poll_params_64, sockets[signaled] );
+    if (!(output = calloc( 1, size ))) goto done;
+    output->timeout = params->timeout;
+    output->exclusive = params->exclusive;
+    for (i = 0; i < params->count; ++i)
+    {
+        if (!pollfds[i].events) continue;
+        output->sockets[output->count].socket = params->sockets[i].socket;
+        output->sockets[output->count].flags = pollfds[i].events;
+        output->sockets[output->count].status = STATUS_SUCCESS;
+        ++output->count;
+    }
+    memcpy( out_buffer, output, size );
+    free( output );
+
+    TRACE( "%u of %u sockets signaled\n", signaled, params->count );
+    status = STATUS_SUCCESS;
+    complete_async( handle, event, apc, apc_user, io, status, size );
+
+done:
+    free( pollfds );
+    return status;
+}
+
+/* Accept a pending connection on a listening socket whose unix fd is cached,
+ * and register the new fd with the server, instead of asking the server to
+ * accept it. Returns STATUS_BAD_DEVICE_TYPE if the server needs to handle it,
+ * e.g. if no connection is pending, or if accepts queued on the server took
+ * the connection. */
+static NTSTATUS try_accept( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                            IO_STATUS_BLOCK *io, void *out_buffer, ULONG out_size )
+{
+    enum server_fd_type type;
+    obj_handle_t accept_handle = 0;
+    NTSTATUS status;
+    int fd, acceptfd;
+
+    if (out_size != sizeof(accept_handle)) return STATUS_BAD_DEVICE_TYPE;
+    if (server_get_cached_unix_fd( handle, &fd, &type ) || type != FD_TYPE_SOCKET)
+        return STATUS_BAD_DEVICE_TYPE;
+
+#ifdef HAVE_ACCEPT4
+    if ((acceptfd = accept4( fd, NULL, NULL, SOCK_CLOEXEC )) == -1 && errno == ENOSYS)
+#endif
+    {
+        if ((acceptfd = accept( fd, NULL, NULL )) != -1) fcntl( acceptfd, F_SETFD, FD_CLOEXEC );
+    }
+    if (acceptfd == -1) return STATUS_BAD_DEVICE_TYPE;
+
+    wine_server_send_fd( acceptfd );
+    SERVER_START_REQ( register_accepted_socket )
+    {
+        req->listen = wine_server_obj_handle( handle );
+        req->fd     = acceptfd;
+        if (!(status = wine_server_call( req ))) accept_handle = reply->handle;
+    }
+    SERVER_END_REQ;
+    close( acceptfd );
+    if (status) return status;
+    /* the server gave the connection to an accept queued before us */
+    if (!accept_handle) return STATUS_BAD_DEVICE_TYPE;
+
+    TRACE( "accepted fd %d as handle %#x\n", acceptfd, accept_handle );
+    memcpy( out_buffer, &accept_handle, sizeof(accept_handle) );
+    complete_async( handle, event, apc, apc_user, io, STATUS_SUCCESS, sizeof(accept_handle) );
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user, IO_STATUS_BLOCK *io,
                      ULONG code, void *in_buffer, ULONG in_size, void *out_buffer, ULONG out_size )
 {
@@ -1239,8 +1496,13 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
             status = STATUS_BAD_DEVICE_TYPE;
             break;
 
+        case IOCTL_AFD_WINE_ACCEPT:
+            status = try_accept( handle, event, apc, apc_user, io, out_buffer, out_size );
+            break;
+
         case IOCTL_AFD_POLL:
-            status = STATUS_BAD_DEVICE_TYPE;
+            status = try_poll_sockets( handle, event, apc, apc_user, io, in_buffer, in_size,
+                                       out_buffer, out_size );
             break;
 
         case IOCTL_AFD_RECV:
@@ -2195,6 +2457,44 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
         case IOCTL_AFD_WINE_SET_TCP_NODELAY:
             return do_setsockopt( handle, io, IPPROTO_TCP, TCP_NODELAY, in_buffer, in_size );
 
+#ifdef UDP_SEGMENT
+        case IOCTL_AFD_WINE_GET_UDP_SEND_MSG_SIZE:
+            if (get_sock_type( handle ) != SOCK_DGRAM) return STATUS_INVALID_PARAMETER;
+            return do_getsockopt( handle, io, IPPROTO_UDP, UDP_SEGMENT, out_buffer, out_size );
+
+        case IOCTL_AFD_WINE_SET_UDP_SEND_MSG_SIZE:
+            if (get_sock_type( handle ) != SOCK_DGRAM) return STATUS_INVALID_PARAMETER;
+            return do_setsockopt( handle, io, IPPROTO_UDP, UDP_SEGMENT, in_buffer, in_size );
+#endif
+
+#ifdef UDP_GRO
+        case IOCTL_AFD_WINE_GET_UDP_RECV_MAX_COALESCED_SIZE:
+        {
+            int value;
+
+            if (get_sock_type( handle ) != SOCK_DGRAM) return STATUS_INVALID_PARAMETER;
+            if (out_size < sizeof(DWORD)) return STATUS_BUFFER_TOO_SMALL;
+            if ((status = do_getsockopt( handle, NULL, IPPROTO_UDP, UDP_GRO, &value, sizeof(value) )))
+                return status;
+            *(DWORD *)out_buffer = value ? MAX_UDP_COALESCED_SIZE : 0;
+            io->Status = STATUS_SUCCESS;
+            io->Information = sizeof(DWORD);
+            return STATUS_SUCCESS;
+        }
+
+        case IOCTL_AFD_WINE_SET_UDP_RECV_MAX_COALESCED_SIZE:
+        {
+            int value;
+
+            if (get_sock_type( handle ) != SOCK_DGRAM) return STATUS_INVALID_PARAMETER;
+            if (in_size < sizeof(DWORD)) return STATUS_BUFFER_TOO_SMALL;
+            /* Linux coalesces up to the maximum datagram size, which would
+             * truncate receives into smaller buffers; leave it disabled then */
+            value = *(const DWORD *)in_buffer >= MAX_UDP_COALESCED_SIZE;
+            return do_setsockopt( handle, io, IPPROTO_UDP, UDP_GRO, &value, sizeof(value) );
+        }
+#endif
+
         default:
         {
             if ((code >> 16) == FILE_DEVICE_NETWORK)
@@ -181,8 +181,10 @@ extern unsigned int server_queue_process_apc( HANDLE process, const apc_call_t *
                                               apc_result_t *result ) DECLSPEC_HIDDEN;
 extern int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
                                int *needs_close, enum server_fd_type *type, unsigned int *options ) DECLSPEC_HIDDEN;
+extern int server_get_cached_unix_fd( HANDLE handle, int *unix_fd, enum server_fd_type *type ) DECLSPEC_HIDDEN;
 extern void wine_server_send_fd( int fd ) DECLSPEC_HIDDEN;
 extern void process_exit_wrapper( int status ) DECLSPEC_HIDDEN;
+extern const char * HOSTPTR get_server_dir(void) DECLSPEC_HIDDEN;
 extern size_t server_init_process(void) DECLSPEC_HIDDEN;
 extern void server_init_process_done(void) DECLSPEC_HIDDEN;
 extern void server_init_thread( void *entry_point, BOOL *suspend ) DECLSPEC_HIDDEN;
@@ -207,6 +209,7 @@ extern NTSTATUS alloc_object_attributes( const OBJECT_ATTRIBUTES *attr, struct o
 
 extern void * HOSTPTR anon_mmap_fixed( void * HOSTPTR start, size_t size, int prot, int flags ) DECLSPEC_HIDDEN;
 extern void * HOSTPTR anon_mmap_alloc( size_t size, int prot ) DECLSPEC_HIDDEN;
+extern BOOL virtual_reserve_exe_range(void) DECLSPEC_HIDDEN;
 extern void virtual_init(void) DECLSPEC_HIDDEN;
 extern ULONG_PTR get_system_affinity_mask(void) DECLSPEC_HIDDEN;
 extern void virtual_get_system_info( SYSTEM_BASIC_INFORMATION *info, BOOL wow64 ) DECLSPEC_HIDDEN;
@@ -292,9 +295,16 @@ extern NTSTATUS get_device_info( int fd, struct _FILE_FS_DEVICE_INFORMATION *inf
 extern void init_files(void) DECLSPEC_HIDDEN;
 extern void init_cpu_info(void) DECLSPEC_HIDDEN;
 extern void add_completion( HANDLE handle, ULONG_PTR value, NTSTATUS status, ULONG info, BOOL async ) DECLSPEC_HIDDEN;
+extern void release_pipe_shm( int fd ) DECLSPEC_HIDDEN;
+extern void invalidate_file_info_cache(void) DECLSPEC_HIDDEN;
+extern void remove_file_info_cache( HANDLE handle ) DECLSPEC_HIDDEN;
 extern void set_async_direct_result( HANDLE *optional_handle, NTSTATUS status, ULONG_PTR information );
 
 extern void dbg_init(void) DECLSPEC_HIDDEN;
+extern void dbg_reset_trace(void) DECLSPEC_HIDDEN;
+extern LONGLONG startup_trace_start(void) DECLSPEC_HIDDEN;
+extern void CDECL startup_trace( const char *name, const WCHAR *arg, LONGLONG start, DWORD tid ) DECLSPEC_HIDDEN;
+extern void startup_trace_write(void) DECLSPEC_HIDDEN;
 
 extern void WINAPI DECLSPEC_NORETURN call_user_apc_dispatcher( CONTEXT *context_ptr, ULONG_PTR ctx, ULONG_PTR arg1, ULONG_PTR arg2, PNTAPCFUNC func,
 void (WINAPI *dispatcher)(CONTEXT*,ULONG_PTR,ULONG_PTR,ULONG_PTR,PNTAPCFUNC)) DECLSPEC_HIDDEN;
@@ -2693,6 +2693,51 @@ static int CDECL alloc_virtual_heap( void * HOSTPTR base, SIZE_T size, void * HO
     return (alloc->base != MAP_FAILED_HOSTPTR);
 }
 
+/***********************************************************************
+ *           virtual_reserve_exe_range
+ *
+ * Reserve the WINEPRELOADRESERVE range in a process forked from the zygote, the way
+ * the preloader would have done it if the process had been exec'ed.
+ * Must be called before virtual_init().
+ */
+BOOL virtual_reserve_exe_range(void)
+{
+    struct preload_info * HOSTPTR * HOSTPTR preload_info = dlsym( RTLD_DEFAULT, "wine_main_preload_info" );
+    const char * HOSTPTR preload = getenv( "WINEPRELOADRESERVE" );
+    unsigned long start, end;
+    void * HOSTPTR ptr;
+    int i;
+
+    if (!preload || sscanf( preload, "%lx-%lx", &start, &end ) != 2 || start >= end) return TRUE;
+    if (!preload_info || !*preload_info) return TRUE;  /* nothing is reserved without the preloader */
+
+    for (i = 0; (*preload_info)[i].size; i++)
+    {
+        unsigned long area_start = (unsigned long)(*preload_info)[i].addr;
+        unsigned long area_end = area_start + (*preload_info)[i].size;
+
+        if (start >= area_start && end <= area_end) return TRUE;  /* already reserved */
+        if (start < area_end && end > area_start) return FALSE;
+    }
+
+#ifdef MAP_FIXED_NOREPLACE
+    ptr = mmap( (void * HOSTPTR)start, end - start, PROT_NONE,
+                MAP_FIXED_NOREPLACE | MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0 );
+#else
+    ptr = mmap( (void * HOSTPTR)start, end - start, PROT_NONE, MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0 );
+#endif
+    if (ptr == MAP_FAILED_HOSTPTR) return FALSE;
+    if (ptr != (void * HOSTPTR)start)
+    {
+        munmap( ptr, end - start );
+        return FALSE;
+    }
+    /* the preloader leaves a free slot for the exe range before the end of the list */
+    (*preload_info)[i].addr = ptr;
+    (*preload_info)[i].size = end - start;
+    return TRUE;
+}
+
 /***********************************************************************
  *           virtual_init
  */
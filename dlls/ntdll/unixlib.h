@@ -24,7 +24,7 @@
 struct _DISPATCHER_CONTEXT;
 
 /* increment this when you change the function table */
-#define NTDLL_UNIXLIB_VERSION 134
+#define NTDLL_UNIXLIB_VERSION 135
 
 struct unix_funcs
 {
@@ -36,6 +36,7 @@ struct unix_funcs
     /* other Win32 API functions */
     LONGLONG      (WINAPI *RtlGetSystemTimePrecise)(void);
     void *        (CDECL *dlsym_unix_ntdll)( const char *func );
+    void          (CDECL *startup_trace)( const char *name, const WCHAR *arg, LONGLONG start, DWORD tid );
 #ifdef __aarch64__
     TEB *         (WINAPI *NtCurrentTeb)(void);
 #endif
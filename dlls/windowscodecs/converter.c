@@ -137,6 +137,129 @@ static inline FormatConverter *impl_from_IWICFormatConverter(IWICFormatConverter
     return CONTAINING_RECORD(iface, FormatConverter, IWICFormatConverter_iface);
 }
 
+/* The helpers below convert pixels in place. The source rows are stored at
+ * the start of each destination row, so no intermediate buffer is needed. */
+
+static void expand_24bpp_to_32bppBGRA(BYTE *buffer, INT width, INT height, UINT stride, BOOL swap_rb)
+{
+    INT x, y;
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *row = buffer + stride * y;
+
+        /* go backwards, so that the source pixels are read before being overwritten */
+        for (x = width - 1; x >= 0; x--)
+        {
+            BYTE b = row[3 * x], g = row[3 * x + 1], r = row[3 * x + 2];
+
+            if (swap_rb)
+            {
+                BYTE tmp = b;
+                b = r;
+                r = tmp;
+            }
+            *(DWORD *)(row + 4 * x) = 0xff000000 | (r << 16) | (g << 8) | b;
+        }
+    }
+}
+
+static void expand_8bppGray_to_32bppBGRA(BYTE *buffer, INT width, INT height, UINT stride)
+{
+    INT x, y;
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *row = buffer + stride * y;
+
+        for (x = width - 1; x >= 0; x--)
+        {
+            DWORD gray = row[x];
+            *(DWORD *)(row + 4 * x) = 0xff000000 | (gray << 16) | (gray << 8) | gray;
+        }
+    }
+}
+
+static void shrink_32bpp_to_24bpp(BYTE *buffer, INT width, INT height, UINT stride, BOOL swap_rb)
+{
+    INT x, y;
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *row = buffer + stride * y;
+
+        /* go forwards, a pixel can only overwrite the source of pixels before it */
+        for (x = 0; x < width; x++)
+        {
+            BYTE b = row[4 * x], g = row[4 * x + 1], r = row[4 * x + 2];
+
+            row[3 * x] = swap_rb ? r : b;
+            row[3 * x + 1] = g;
+            row[3 * x + 2] = swap_rb ? b : r;
+        }
+    }
+}
+
+/* Check whether the destination buffer can hold the source data for an in place conversion. */
+static BOOL can_convert_in_place(const WICRect *prc, UINT src_bpp, UINT stride, UINT buffersize)
+{
+    UINT srcstride = (prc->Width * src_bpp + 7) / 8;
+
+    return prc->Height > 0 && stride >= srcstride && stride * (prc->Height - 1) + srcstride <= buffersize;
+}
+
+/* Multiply the color channels of 32bpp pixels by the alpha in the fourth byte.
+ * (t + 1 + ((t + 1) >> 8)) >> 8 is t / 255 for every t up to 255 * 255. */
+static void premultiply_alpha(BYTE *bits, UINT width, UINT height, UINT stride)
+{
+    UINT x, y, t;
+    BYTE *pixel;
+
+    for (y = 0; y < height; y++)
+    {
+        pixel = bits + stride * y;
+        for (x = 0; x < width; x++, pixel += 4)
+        {
+            BYTE alpha = pixel[3];
+
+            if (alpha == 255) continue;
+            t = pixel[0] * alpha + 1;
+            pixel[0] = (t + (t >> 8)) >> 8;
+            t = pixel[1] * alpha + 1;
+            pixel[1] = (t + (t >> 8)) >> 8;
+            t = pixel[2] * alpha + 1;
+            pixel[2] = (t + (t >> 8)) >> 8;
+        }
+    }
+}
+
+/* Divide the color channels of 32bpp pixels by the alpha in the fourth byte,
+ * using a 16.16 reciprocal of each alpha value, which gives the same results
+ * as value * 255 / alpha. */
+static void unpremultiply_alpha(BYTE *bits, UINT width, UINT height, UINT stride)
+{
+    UINT recip[255];
+    UINT x, y;
+    BYTE *pixel;
+
+    for (x = 1; x < 255; x++)
+        recip[x] = ((255 << 16) + x - 1) / x;
+
+    for (y = 0; y < height; y++)
+    {
+        pixel = bits + stride * y;
+        for (x = 0; x < width; x++, pixel += 4)
+        {
+            BYTE alpha = pixel[3];
+
+            if (alpha == 0 || alpha == 255) continue;
+            pixel[0] = (pixel[0] * recip[alpha]) >> 16;
+            pixel[1] = (pixel[1] * recip[alpha]) >> 16;
+            pixel[2] = (pixel[2] * recip[alpha]) >> 16;
+        }
+    }
+}
+
 static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRect *prc,
     UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer, enum pixelformat source_format)
 {
@@ -337,41 +460,10 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         if (prc)
         {
             HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcbyte;
-            BYTE *dstrow;
-            DWORD *dstpixel;
-
-            srcstride = prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
 
+            res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcbyte = srcrow;
-                    dstpixel=(DWORD*)dstrow;
-                    for (x=0; x<prc->Width; x++)
-                    {
-                        *dstpixel++ = 0xff000000|(*srcbyte<<16)|(*srcbyte<<8)|*srcbyte;
-                        srcbyte++;
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
+                expand_8bppGray_to_32bppBGRA(pbBuffer, prc->Width, prc->Height, cbStride);
             return res;
         }
         return S_OK;
@@ -616,93 +708,15 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         }
         return S_OK;
     case format_24bppBGR:
-        if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcpixel;
-            BYTE *dstrow;
-            BYTE *dstpixel;
-
-            srcstride = 3 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=srcrow;
-                    dstpixel=dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        *dstpixel++=*srcpixel++; /* blue */
-                        *dstpixel++=*srcpixel++; /* green */
-                        *dstpixel++=*srcpixel++; /* red */
-                        *dstpixel++=255; /* alpha */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
-        return S_OK;
     case format_24bppRGB:
         if (prc)
         {
             HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcpixel;
-            BYTE *dstrow;
-            BYTE *dstpixel;
-            BYTE tmppixel[3];
-
-            srcstride = 3 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
 
+            res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=srcrow;
-                    dstpixel=dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        tmppixel[0]=*srcpixel++; /* red */
-                        tmppixel[1]=*srcpixel++; /* green */
-                        tmppixel[2]=*srcpixel++; /* blue */
-
-                        *dstpixel++=tmppixel[2]; /* blue */
-                        *dstpixel++=tmppixel[1]; /* green */
-                        *dstpixel++=tmppixel[0]; /* red */
-                        *dstpixel++=255; /* alpha */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
+                expand_24bpp_to_32bppBGRA(pbBuffer, prc->Width, prc->Height, cbStride,
+                                          source_format == format_24bppRGB);
             return res;
         }
         return S_OK;
@@ -738,22 +752,11 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         if (prc)
         {
             HRESULT res;
-            INT x, y;
 
             res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(res)) return res;
 
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+            unpremultiply_alpha(pbBuffer, prc->Width, prc->Height, cbStride);
         }
         return S_OK;
     case format_48bppRGB:
@@ -902,22 +905,10 @@ static HRESULT copypixels_to_32bppRGBA(struct FormatConverter *This, const WICRe
     case format_32bppPRGBA:
         if (prc)
         {
-            INT x, y;
-
             hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(hr)) return hr;
 
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+            unpremultiply_alpha(pbBuffer, prc->Width, prc->Height, cbStride);
         }
         return S_OK;
 
@@ -972,24 +963,19 @@ static HRESULT copypixels_to_32bppPBGRA(struct FormatConverter *This, const WICR
         if (prc)
             return IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
         return S_OK;
+    case format_32bppPRGBA:
+        /* swap the channels directly rather than unpremultiplying and premultiplying again */
+        if (prc)
+        {
+            hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+            if (FAILED(hr)) return hr;
+            reverse_bgr8(4, pbBuffer, prc->Width, prc->Height, cbStride);
+        }
+        return S_OK;
     default:
         hr = copypixels_to_32bppBGRA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
-        {
-            INT x, y;
-
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * alpha / 255;
-                    }
-                }
-        }
+            premultiply_alpha(pbBuffer, prc->Width, prc->Height, cbStride);
         return hr;
     }
 }
@@ -1005,24 +991,19 @@ static HRESULT copypixels_to_32bppPRGBA(struct FormatConverter *This, const WICR
         if (prc)
             return IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
         return S_OK;
+    case format_32bppPBGRA:
+        /* swap the channels directly rather than unpremultiplying and premultiplying again */
+        if (prc)
+        {
+            hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+            if (FAILED(hr)) return hr;
+            reverse_bgr8(4, pbBuffer, prc->Width, prc->Height, cbStride);
+        }
+        return S_OK;
     default:
         hr = copypixels_to_32bppRGBA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
-        {
-            INT x, y;
-
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * alpha / 255;
-                    }
-                }
-        }
+            premultiply_alpha(pbBuffer, prc->Width, prc->Height, cbStride);
         return hr;
     }
 }
@@ -1059,6 +1040,15 @@ static HRESULT copypixels_to_24bppBGR(struct FormatConverter *This, const WICRec
             BYTE *dstrow;
             BYTE *dstpixel;
 
+            if (can_convert_in_place(prc, 32, cbStride, cbBufferSize))
+            {
+                res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+                if (SUCCEEDED(res))
+                    shrink_32bpp_to_24bpp(pbBuffer, prc->Width, prc->Height, cbStride,
+                                          source_format == format_32bppRGBA);
+                return res;
+            }
+
             srcstride = 4 * prc->Width;
             srcdatasize = srcstride * prc->Height;
 
@@ -1234,6 +1224,14 @@ static HRESULT copypixels_to_24bppRGB(struct FormatConverter *This, const WICRec
             BYTE *dstpixel;
             BYTE tmppixel[3];
 
+            if (can_convert_in_place(prc, 32, cbStride, cbBufferSize))
+            {
+                res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+                if (SUCCEEDED(res))
+                    shrink_32bpp_to_24bpp(pbBuffer, prc->Width, prc->Height, cbStride, TRUE);
+                return res;
+            }
+
             srcstride = 4 * prc->Width;
             srcdatasize = srcstride * prc->Height;
 
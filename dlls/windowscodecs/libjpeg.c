@@ -78,6 +78,8 @@ struct jpeg_decoder {
     struct jpeg_error_mgr jerr;
     struct jpeg_source_mgr source_mgr;
     BYTE source_buffer[1024];
+    ULONGLONG stream_pos;
+    HRESULT scanlines_hr;
     UINT stride;
     BYTE *image_data;
 };
@@ -150,7 +152,7 @@ static HRESULT CDECL jpeg_decoder_initialize(struct decoder* iface, IStream *str
     struct jpeg_decoder *This = impl_from_decoder(iface);
     int ret;
     jmp_buf jmpbuf;
-    UINT data_size, i;
+    UINT data_size;
 
     if (This->cinfo_initialized)
         return WINCODEC_ERR_WRONGSTATE;
@@ -252,52 +254,80 @@ static HRESULT CDECL jpeg_decoder_initialize(struct decoder* iface, IStream *str
     if (!This->image_data)
         return E_OUTOFMEMORY;
 
-    while (This->cinfo.output_scanline < This->cinfo.output_height)
+    /* scanlines are decoded on demand in copy_pixels */
+    stream_seek(This->stream, 0, STREAM_SEEK_CUR, &This->stream_pos);
+    This->scanlines_hr = S_OK;
+
+    st->frame_count = 1;
+    st->flags = WICBitmapDecoderCapabilityCanDecodeAllImages |
+                WICBitmapDecoderCapabilityCanDecodeSomeImages |
+                WICBitmapDecoderCapabilityCanEnumerateMetadata |
+                DECODER_FLAGS_UNSUPPORTED_COLOR_CONTEXT;
+    return S_OK;
+}
+
+static HRESULT CDECL jpeg_decoder_get_frame_info(struct decoder* iface, UINT frame, struct decoder_frame *info)
+{
+    struct jpeg_decoder *This = impl_from_decoder(iface);
+    *info = This->frame;
+    return S_OK;
+}
+
+/* Decode the scanlines up to, but not including, the given row. */
+static HRESULT jpeg_decoder_read_scanlines(struct jpeg_decoder *This, UINT end)
+{
+    jmp_buf jmpbuf;
+    UINT first_scanline, rows, i;
+    BYTE *data;
+
+    if (This->cinfo.output_scanline >= end || FAILED(This->scanlines_hr))
+        return This->scanlines_hr;
+
+    This->cinfo.client_data = jmpbuf;
+
+    if (setjmp(jmpbuf))
+        return This->scanlines_hr = E_FAIL;
+
+    /* the stream may have been used by someone else since the last call */
+    stream_seek(This->stream, This->stream_pos, STREAM_SEEK_SET, NULL);
+
+    first_scanline = This->cinfo.output_scanline;
+    while (This->cinfo.output_scanline < end)
     {
-        UINT first_scanline = This->cinfo.output_scanline;
         UINT max_rows;
         JSAMPROW out_rows[4];
         JDIMENSION ret;
 
-        max_rows = min(This->cinfo.output_height-first_scanline, 4);
+        max_rows = min(end - This->cinfo.output_scanline, 4);
         for (i=0; i<max_rows; i++)
-            out_rows[i] = This->image_data + This->stride * (first_scanline+i);
+            out_rows[i] = This->image_data + This->stride * (This->cinfo.output_scanline+i);
 
         ret = jpeg_read_scanlines(&This->cinfo, out_rows, max_rows);
         if (ret == 0)
         {
             ERR("read_scanlines failed\n");
-            return E_FAIL;
+            return This->scanlines_hr = E_FAIL;
         }
     }
 
+    stream_seek(This->stream, 0, STREAM_SEEK_CUR, &This->stream_pos);
+
+    data = This->image_data + This->stride * first_scanline;
+    rows = This->cinfo.output_scanline - first_scanline;
+
     if (This->frame.bpp == 24)
     {
         /* libjpeg gives us RGB data and we want BGR, so byteswap the data */
-        reverse_bgr8(3, This->image_data,
-            This->cinfo.output_width, This->cinfo.output_height,
-            This->stride);
+        reverse_bgr8(3, data, This->cinfo.output_width, rows, This->stride);
     }
 
     if (This->cinfo.out_color_space == JCS_CMYK && This->cinfo.saw_Adobe_marker)
     {
         /* Adobe JPEG's have inverted CMYK data. */
-        for (i=0; i<data_size; i++)
-            This->image_data[i] ^= 0xff;
+        for (i=0; i<This->stride * rows; i++)
+            data[i] ^= 0xff;
     }
 
-    st->frame_count = 1;
-    st->flags = WICBitmapDecoderCapabilityCanDecodeAllImages |
-                WICBitmapDecoderCapabilityCanDecodeSomeImages |
-                WICBitmapDecoderCapabilityCanEnumerateMetadata |
-                DECODER_FLAGS_UNSUPPORTED_COLOR_CONTEXT;
-    return S_OK;
-}
-
-static HRESULT CDECL jpeg_decoder_get_frame_info(struct decoder* iface, UINT frame, struct decoder_frame *info)
-{
-    struct jpeg_decoder *This = impl_from_decoder(iface);
-    *info = This->frame;
     return S_OK;
 }
 
@@ -305,6 +335,16 @@ static HRESULT CDECL jpeg_decoder_copy_pixels(struct decoder* iface, UINT frame,
     const WICRect *prc, UINT stride, UINT buffersize, BYTE *buffer)
 {
     struct jpeg_decoder *This = impl_from_decoder(iface);
+    UINT end = This->frame.height;
+    HRESULT hr;
+
+    /* only decode as far as the bottom of the requested rectangle */
+    if (prc && prc->Y >= 0 && prc->Height >= 0 && prc->Y + prc->Height <= end)
+        end = prc->Y + prc->Height;
+
+    if (FAILED(hr = jpeg_decoder_read_scanlines(This, end)))
+        return hr;
+
     return copy_pixels(This->frame.bpp, This->image_data,
         This->frame.width, This->frame.height, This->stride,
         prc, stride, buffersize, buffer);
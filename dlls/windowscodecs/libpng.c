@@ -40,6 +40,11 @@ struct png_decoder
     struct decoder decoder;
     IStream *stream;
     struct decoder_frame decoder_frame;
+    png_structp png_ptr;
+    png_infop info_ptr;
+    ULONGLONG stream_pos;
+    HRESULT rows_hr;
+    UINT rows_read;
     UINT stride;
     BYTE *image_bits;
     BYTE *color_profile;
@@ -64,6 +69,57 @@ static void user_read_data(png_structp png_ptr, png_bytep data, png_size_t lengt
     }
 }
 
+/* Walk the chunks after the header so that a truncated stream fails here
+ * rather than in copy_pixels; only the pixel data is left to be decoded. */
+static HRESULT png_check_chunks(IStream *stream)
+{
+    ULONGLONG start, pos, size;
+    BOOL has_idat = FALSE;
+    ULONG bytesread, length;
+    BYTE header[8];
+    HRESULT hr;
+
+    hr = stream_seek(stream, 0, STREAM_SEEK_CUR, &start);
+    if (SUCCEEDED(hr))
+        hr = stream_seek(stream, 0, STREAM_SEEK_END, &size);
+    if (FAILED(hr)) return hr;
+
+    for (pos = 8; pos + sizeof(header) <= size; pos += length + 12)
+    {
+        hr = stream_seek(stream, pos, STREAM_SEEK_SET, NULL);
+        if (SUCCEEDED(hr))
+            hr = stream_read(stream, header, sizeof(header), &bytesread);
+        if (FAILED(hr)) break;
+        if (bytesread != sizeof(header))
+        {
+            hr = WINCODEC_ERR_UNKNOWNIMAGEFORMAT;
+            break;
+        }
+
+        length = header[0] << 24 | header[1] << 16 | header[2] << 8 | header[3];
+        if (length > 0x7fffffff || pos + length + 12 > size)
+        {
+            WARN("chunk %s at %s is truncated\n", debugstr_an((char *)header + 4, 4), wine_dbgstr_longlong(pos));
+            hr = WINCODEC_ERR_UNKNOWNIMAGEFORMAT;
+            break;
+        }
+
+        if (!memcmp(header + 4, "IDAT", 4))
+            has_idat = TRUE;
+        else if (!memcmp(header + 4, "IEND", 4))
+            break;
+    }
+
+    if (SUCCEEDED(hr) && !has_idat)
+    {
+        WARN("no image data\n");
+        hr = WINCODEC_ERR_UNKNOWNIMAGEFORMAT;
+    }
+
+    stream_seek(stream, start, STREAM_SEEK_SET, NULL);
+    return hr;
+}
+
 static HRESULT CDECL png_decoder_initialize(struct decoder *iface, IStream *stream, struct decoder_stat *st)
 {
     struct png_decoder *This = impl_from_decoder(iface);
@@ -305,20 +361,35 @@ static HRESULT CDECL png_decoder_initialize(struct decoder *iface, IStream *stre
         goto end;
     }
 
-    row_pointers = malloc(sizeof(png_bytep)*This->decoder_frame.height);
-    if (!row_pointers)
+    if (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE)
     {
-        hr = E_OUTOFMEMORY;
-        goto end;
-    }
+        /* every pass has to be read before any row is complete */
+        row_pointers = malloc(sizeof(png_bytep)*This->decoder_frame.height);
+        if (!row_pointers)
+        {
+            hr = E_OUTOFMEMORY;
+            goto end;
+        }
 
-    for (i=0; i<This->decoder_frame.height; i++)
-        row_pointers[i] = This->image_bits + i * This->stride;
+        for (i=0; i<This->decoder_frame.height; i++)
+            row_pointers[i] = This->image_bits + i * This->stride;
 
-    png_read_image(png_ptr, row_pointers);
+        png_read_image(png_ptr, row_pointers);
 
-    free(row_pointers);
-    row_pointers = NULL;
+        free(row_pointers);
+        row_pointers = NULL;
+
+        This->rows_read = This->decoder_frame.height;
+    }
+    else
+    {
+        /* rows are decoded on demand in copy_pixels */
+        hr = png_check_chunks(stream);
+        if (FAILED(hr))
+            goto end;
+        This->rows_read = 0;
+    }
+    This->rows_hr = S_OK;
 
     /* png_read_end intentionally not called to not seek to the end of the file */
 
@@ -329,10 +400,20 @@ static HRESULT CDECL png_decoder_initialize(struct decoder *iface, IStream *stre
 
     This->stream = stream;
 
+    if (This->rows_read < This->decoder_frame.height)
+    {
+        stream_seek(stream, 0, STREAM_SEEK_CUR, &This->stream_pos);
+        This->png_ptr = png_ptr;
+        This->info_ptr = info_ptr;
+        png_ptr = NULL;
+        info_ptr = NULL;
+    }
+
     hr = S_OK;
 
 end:
-    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    if (png_ptr)
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
     free(row_pointers);
     if (FAILED(hr))
     {
@@ -351,10 +432,50 @@ static HRESULT CDECL png_decoder_get_frame_info(struct decoder *iface, UINT fram
     return S_OK;
 }
 
+/* Decode the rows up to, but not including, the given row. */
+static HRESULT png_decoder_read_rows(struct png_decoder *This, UINT end)
+{
+    if (This->rows_read >= end)
+        return S_OK;
+    if (FAILED(This->rows_hr))
+        return This->rows_hr;
+
+    if (setjmp(png_jmpbuf(This->png_ptr)))
+    {
+        png_destroy_read_struct(&This->png_ptr, &This->info_ptr, NULL);
+        return This->rows_hr = E_FAIL;
+    }
+
+    /* the stream may have been used by someone else since the last call */
+    stream_seek(This->stream, This->stream_pos, STREAM_SEEK_SET, NULL);
+
+    while (This->rows_read < end)
+    {
+        png_read_row(This->png_ptr, This->image_bits + This->rows_read * This->stride, NULL);
+        This->rows_read++;
+    }
+
+    if (This->rows_read == This->decoder_frame.height)
+        png_destroy_read_struct(&This->png_ptr, &This->info_ptr, NULL);
+    else
+        stream_seek(This->stream, 0, STREAM_SEEK_CUR, &This->stream_pos);
+
+    return S_OK;
+}
+
 static HRESULT CDECL png_decoder_copy_pixels(struct decoder *iface, UINT frame,
     const WICRect *prc, UINT stride, UINT buffersize, BYTE *buffer)
 {
     struct png_decoder *This = impl_from_decoder(iface);
+    UINT end = This->decoder_frame.height;
+    HRESULT hr;
+
+    /* only decode as far as the bottom of the requested rectangle */
+    if (prc && prc->Y >= 0 && prc->Height >= 0 && prc->Y + prc->Height <= end)
+        end = prc->Y + prc->Height;
+
+    if (FAILED(hr = png_decoder_read_rows(This, end)))
+        return hr;
 
     return copy_pixels(This->decoder_frame.bpp, This->image_bits,
         This->decoder_frame.width, This->decoder_frame.height, This->stride,
@@ -454,6 +575,8 @@ static void CDECL png_decoder_destroy(struct decoder* iface)
 {
     struct png_decoder *This = impl_from_decoder(iface);
 
+    if (This->png_ptr)
+        png_destroy_read_struct(&This->png_ptr, &This->info_ptr, NULL);
     free(This->image_bits);
     free(This->color_profile);
     RtlFreeHeap(GetProcessHeap(), 0, This);
@@ -480,6 +603,8 @@ HRESULT CDECL png_decoder_create(struct decoder_info *info, struct decoder **res
     }
 
     This->decoder.vtable = &png_decoder_vtable;
+    This->png_ptr = NULL;
+    This->info_ptr = NULL;
     This->image_bits = NULL;
     This->color_profile = NULL;
     *result = &This->decoder;
@@ -56,6 +56,7 @@ static void test_decode_adobe_cmyk(void)
     GUID guidresult;
     UINT count=0, width=0, height=0;
     BYTE imagedata[5 * 4] = {1};
+    WICRect rc = {0, 0, 1, 2};
     UINT i;
 
     const BYTE expected_imagedata[5 * 4] = {
@@ -121,6 +122,13 @@ static void test_decode_adobe_cmyk(void)
                     broken(IsEqualGUID(&guidresult, &GUID_WICPixelFormat24bppBGR)), /* xp/2003 */
                     "unexpected pixel format: %s\n", wine_dbgstr_guid(&guidresult));
 
+                /* Copy the top rows first, before the rest of the image is needed */
+                hr = IWICBitmapFrameDecode_CopyPixels(framedecode, &rc, 4, sizeof(imagedata), imagedata);
+                ok(SUCCEEDED(hr), "CopyPixels failed, hr=%lx\n", hr);
+                ok(!memcmp(imagedata, expected_imagedata, 2 * 4) ||
+                        broken(!memcmp(imagedata, expected_imagedata_24bpp, 2 * 4)), /* xp/2003 */
+                        "unexpected image data\n");
+
                 /* We want to be sure our state tracking will not impact output
                  * data on subsequent calls */
                 for(i=2; i>0; --i)
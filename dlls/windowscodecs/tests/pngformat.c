@@ -743,12 +743,11 @@ static void test_color_formats(void)
         { 4, PNG_COLOR_TYPE_RGB, NULL, NULL, NULL },
         { 8, PNG_COLOR_TYPE_RGB,
           &GUID_WICPixelFormat24bppBGR, &GUID_WICPixelFormat24bppBGR, &GUID_WICPixelFormat24bppBGR },
-        /* libpng refuses to load our test image complaining about extra compressed data,
-         * but libpng is still able to load the image with other combination of type/depth
-         * making RGB 16 bpp case special for some reason. Therefore todo = TRUE.
+        /* Our test image doesn't contain enough image data for RGB 16 bpp, but the
+         * image data is only decoded when the pixels are copied.
          */
         { 16, PNG_COLOR_TYPE_RGB,
-          &GUID_WICPixelFormat48bppRGB, &GUID_WICPixelFormat48bppRGB, &GUID_WICPixelFormat48bppRGB, TRUE, TRUE },
+          &GUID_WICPixelFormat48bppRGB, &GUID_WICPixelFormat48bppRGB, &GUID_WICPixelFormat48bppRGB },
         { 24, PNG_COLOR_TYPE_RGB, NULL, NULL, NULL },
         { 32, PNG_COLOR_TYPE_RGB, NULL, NULL, NULL },
         /* 0 - PNG_COLOR_TYPE_GRAY */
@@ -950,6 +949,60 @@ static void test_chunk_size(void)
     IWICBitmapDecoder_Release(decoder);
 }
 
+static const char png_2x3_gray[] = {
+  0x89,'P','N','G',0x0d,0x0a,0x1a,0x0a,
+  0x00,0x00,0x00,0x0d,'I','H','D','R',0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x03,0x08,0x00,0x00,0x00,0x00,0x9c,0x81,0x81,0x5d,
+  0x00,0x00,0x00,0x11,'I','D','A','T',0x78,0x9c,0x63,0x10,0x10,0x64,0x50,0x50,0x64,0x30,0x30,0x04,0x00,0x02,0xb5,0x00,0xc4,
+  0xc7,0xc5,0x70,0xe3,
+  0x00,0x00,0x00,0x00,'I','E','N','D',0xae,0x42,0x60,0x82
+};
+
+static void test_truncated(void)
+{
+    IWICBitmapDecoder *decoder;
+    HRESULT hr;
+
+    /* cut the stream in the middle of the IDAT chunk */
+    hr = create_decoder(png_2x3_gray, sizeof(png_2x3_gray) - 18, &decoder);
+    ok(hr == WINCODEC_ERR_UNKNOWNIMAGEFORMAT, "expected WINCODEC_ERR_UNKNOWNIMAGEFORMAT, got %#lx\n", hr);
+    if (hr == S_OK) IWICBitmapDecoder_Release(decoder);
+}
+
+static void test_copy_pixels(void)
+{
+    static const BYTE expected[] = {0x10,0x11,0x20,0x21,0x30,0x31};
+    WICRect rect_row0 = {0, 0, 2, 1}, rect_row2 = {1, 2, 1, 1};
+    IWICBitmapFrameDecode *frame;
+    IWICBitmapDecoder *decoder;
+    BYTE buf[sizeof(expected)];
+    HRESULT hr;
+
+    hr = create_decoder(png_2x3_gray, sizeof(png_2x3_gray), &decoder);
+    ok(hr == S_OK, "Failed to load PNG image data %#lx\n", hr);
+    if (hr != S_OK) return;
+
+    hr = IWICBitmapDecoder_GetFrame(decoder, 0, &frame);
+    ok(hr == S_OK, "GetFrame error %#lx\n", hr);
+
+    /* copy the rows out of order, the later calls need rows not decoded yet */
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapFrameDecode_CopyPixels(frame, &rect_row0, 2, sizeof(buf), buf);
+    ok(hr == S_OK, "CopyPixels error %#lx\n", hr);
+    ok(!memcmp(buf, expected, 2), "got %02x %02x\n", buf[0], buf[1]);
+
+    hr = IWICBitmapFrameDecode_CopyPixels(frame, &rect_row2, 1, sizeof(buf), buf);
+    ok(hr == S_OK, "CopyPixels error %#lx\n", hr);
+    ok(buf[0] == 0x31, "got %02x\n", buf[0]);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapFrameDecode_CopyPixels(frame, NULL, 2, sizeof(buf), buf);
+    ok(hr == S_OK, "CopyPixels error %#lx\n", hr);
+    ok(!memcmp(buf, expected, sizeof(expected)), "unexpected image data\n");
+
+    IWICBitmapFrameDecode_Release(frame);
+    IWICBitmapDecoder_Release(decoder);
+}
+
 START_TEST(pngformat)
 {
     HRESULT hr;
@@ -964,6 +1017,8 @@ START_TEST(pngformat)
     test_png_palette();
     test_color_formats();
     test_chunk_size();
+    test_copy_pixels();
+    test_truncated();
 
     IWICImagingFactory_Release(factory);
     CoUninitialize();
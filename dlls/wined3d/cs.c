@@ -156,6 +156,8 @@ struct wined3d_cs_present
     RECT dst_rect;
     unsigned int swap_interval;
     DWORD flags;
+    unsigned int dirty_rect_count;
+    RECT dirty_rects[1];
 };
 
 struct wined3d_cs_clear
@@ -640,6 +642,7 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
     struct wined3d_texture *logo_texture, *cursor_texture, *back_buffer;
     struct wined3d_rendertarget_view *dsv = cs->state.fb.depth_stencil;
     const struct wined3d_cs_present *op = data;
+    unsigned int dirty_rect_count = op->dirty_rect_count;
     const struct wined3d_swapchain_desc *desc;
     struct wined3d_swapchain *swapchain;
 
@@ -655,6 +658,7 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
         /* Blit the logo into the upper left corner of the back-buffer. */
         wined3d_device_context_blt(&cs->c, back_buffer, 0, &rect, logo_texture, 0,
                 &rect, WINED3D_BLT_SRC_CKEY, NULL, WINED3D_TEXF_POINT);
+        dirty_rect_count = 0;
     }
 
     if ((cursor_texture = swapchain->device->cursor_texture)
@@ -680,9 +684,12 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
         if (wined3d_clip_blit(&clip_rect, &dst_rect, &src_rect))
             wined3d_device_context_blt(&cs->c, back_buffer, 0, &dst_rect, cursor_texture, 0,
                     &src_rect, WINED3D_BLT_ALPHA_TEST, NULL, WINED3D_TEXF_POINT);
+        /* The cursor may have moved outside the dirty region. */
+        dirty_rect_count = 0;
     }
 
-    swapchain->swapchain_ops->swapchain_present(swapchain, &op->src_rect, &op->dst_rect, op->swap_interval, op->flags);
+    swapchain->swapchain_ops->swapchain_present(swapchain, &op->src_rect, &op->dst_rect,
+            op->dirty_rects, dirty_rect_count, op->swap_interval, op->flags);
 
     /* Discard buffers if the swap effect allows it. */
     back_buffer = swapchain->back_buffers[desc->backbuffer_count - 1];
@@ -716,14 +723,15 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
 }
 
 void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *swapchain,
-        const RECT *src_rect, const RECT *dst_rect, HWND dst_window_override,
-        unsigned int swap_interval, DWORD flags)
+        const RECT *src_rect, const RECT *dst_rect, HWND dst_window_override, const RECT *dirty_rects,
+        unsigned int dirty_rect_count, unsigned int swap_interval, DWORD flags)
 {
     struct wined3d_cs_present *op;
     unsigned int i;
     LONG pending;
 
-    op = wined3d_device_context_require_space(&cs->c, sizeof(*op), WINED3D_CS_QUEUE_DEFAULT);
+    op = wined3d_device_context_require_space(&cs->c,
+            FIELD_OFFSET(struct wined3d_cs_present, dirty_rects[dirty_rect_count]), WINED3D_CS_QUEUE_DEFAULT);
     op->opcode = WINED3D_CS_OP_PRESENT;
     op->dst_window_override = dst_window_override;
     op->swapchain = swapchain;
@@ -731,6 +739,8 @@ void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *sw
     op->dst_rect = *dst_rect;
     op->swap_interval = swap_interval;
     op->flags = flags;
+    op->dirty_rect_count = dirty_rect_count;
+    memcpy(op->dirty_rects, dirty_rects, dirty_rect_count * sizeof(*dirty_rects));
 
     pending = InterlockedIncrement(&cs->pending_presents);
 
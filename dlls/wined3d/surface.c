@@ -1708,7 +1708,7 @@ HRESULT texture2d_blt(struct wined3d_texture *dst_texture, unsigned int dst_sub_
          * undefined. */
         dst_swapchain->state.desc.swap_effect = WINED3D_SWAP_EFFECT_COPY;
         wined3d_swapchain_present(dst_swapchain, NULL, NULL,
-                dst_swapchain->win_handle, dst_swapchain->swap_interval, 0);
+                dst_swapchain->win_handle, NULL, 0, dst_swapchain->swap_interval, 0);
         dst_swapchain->state.desc.swap_effect = swap_effect;
 
         return WINED3D_OK;
@@ -206,13 +206,14 @@ void CDECL wined3d_swapchain_set_window(struct wined3d_swapchain *swapchain, HWN
 
 HRESULT CDECL wined3d_swapchain_present(struct wined3d_swapchain *swapchain,
         const RECT *src_rect, const RECT *dst_rect, HWND dst_window_override,
-        unsigned int swap_interval, DWORD flags)
+        const RECT *dirty_rects, unsigned int dirty_rect_count, unsigned int swap_interval, DWORD flags)
 {
     RECT s, d;
 
-    TRACE("swapchain %p, src_rect %s, dst_rect %s, dst_window_override %p, swap_interval %u, flags %#x.\n",
+    TRACE("swapchain %p, src_rect %s, dst_rect %s, dst_window_override %p, dirty_rects %p, "
+            "dirty_rect_count %u, swap_interval %u, flags %#x.\n",
             swapchain, wine_dbgstr_rect(src_rect), wine_dbgstr_rect(dst_rect),
-            dst_window_override, swap_interval, flags);
+            dst_window_override, dirty_rects, dirty_rect_count, swap_interval, flags);
 
     if (flags)
         FIXME("Ignoring flags %#x.\n", flags);
@@ -239,8 +240,20 @@ HRESULT CDECL wined3d_swapchain_present(struct wined3d_swapchain *swapchain,
         dst_rect = &d;
     }
 
+    /* The previous frame is only guaranteed to still be in the destination
+     * window if the swap effect doesn't discard it. The rectangles are copied
+     * into the present op, so fall back to a full present for large counts
+     * rather than overflowing the command stream. */
+    if (!dirty_rects || swapchain->state.desc.swap_effect == WINED3D_SWAP_EFFECT_DISCARD)
+        dirty_rect_count = 0;
+    else if (dirty_rect_count > WINED3D_MAX_PRESENT_DIRTY_RECTS)
+    {
+        WARN("Ignoring %u dirty rectangles.\n", dirty_rect_count);
+        dirty_rect_count = 0;
+    }
+
     wined3d_cs_emit_present(swapchain->device->cs, swapchain, src_rect,
-            dst_rect, dst_window_override, swap_interval, flags);
+            dst_rect, dst_window_override, dirty_rects, dirty_rect_count, swap_interval, flags);
 
     wined3d_mutex_unlock();
 
@@ -402,10 +415,28 @@ HRESULT CDECL wined3d_swapchain_get_gamma_ramp(const struct wined3d_swapchain *s
     return wined3d_output_get_gamma_ramp(output, ramp);
 }
 
+static bool swapchain_present_is_scaled(const RECT *src_rect, const RECT *dst_rect)
+{
+    return src_rect->right - src_rect->left != dst_rect->right - dst_rect->left
+            || src_rect->bottom - src_rect->top != dst_rect->bottom - dst_rect->top;
+}
+
+/* Clip a dirty rectangle, given in back buffer coordinates, to the source
+ * rectangle, and compute the corresponding unscaled destination rectangle. */
+static bool swapchain_get_dirty_rect(const RECT *src_rect, const RECT *dst_rect,
+        const RECT *dirty_rect, RECT *src, RECT *dst)
+{
+    if (!IntersectRect(src, src_rect, dirty_rect))
+        return false;
+    *dst = *src;
+    OffsetRect(dst, dst_rect->left - src_rect->left, dst_rect->top - src_rect->top);
+    return true;
+}
+
 /* The is a fallback for cases where we e.g. can't create a GL context or
  * Vulkan swapchain for the swapchain window. */
-static void swapchain_blit_gdi(struct wined3d_swapchain *swapchain,
-        struct wined3d_context *context, const RECT *src_rect, const RECT *dst_rect)
+static void swapchain_blit_gdi(struct wined3d_swapchain *swapchain, struct wined3d_context *context,
+        const RECT *src_rect, const RECT *dst_rect, const RECT *dirty_rects, unsigned int dirty_rect_count)
 {
     struct wined3d_texture *back_buffer = swapchain->back_buffers[0];
     D3DKMT_DESTROYDCFROMMEMORY destroy_desc;
@@ -415,11 +446,14 @@ static void swapchain_blit_gdi(struct wined3d_swapchain *swapchain,
     HDC src_dc, dst_dc;
     NTSTATUS status;
     HBITMAP bitmap;
+    unsigned int i;
+    RECT s, d;
 
     static unsigned int once;
 
-    TRACE("swapchain %p, context %p, src_rect %s, dst_rect %s.\n",
-            swapchain, context, wine_dbgstr_rect(src_rect), wine_dbgstr_rect(dst_rect));
+    TRACE("swapchain %p, context %p, src_rect %s, dst_rect %s, dirty_rects %p, dirty_rect_count %u.\n",
+            swapchain, context, wine_dbgstr_rect(src_rect), wine_dbgstr_rect(dst_rect),
+            dirty_rects, dirty_rect_count);
 
     if (!once++)
         FIXME("Using GDI present.\n");
@@ -458,10 +492,22 @@ static void swapchain_blit_gdi(struct wined3d_swapchain *swapchain,
     if (!(dst_dc = GetDCEx(swapchain->win_handle, 0, DCX_USESTYLE | DCX_CACHE)))
         ERR("Failed to get destination DC.\n");
 
-    if (!StretchBlt(dst_dc, dst_rect->left, dst_rect->top, dst_rect->right - dst_rect->left,
+    if (dirty_rect_count && !swapchain_present_is_scaled(src_rect, dst_rect))
+    {
+        for (i = 0; i < dirty_rect_count; ++i)
+        {
+            if (!swapchain_get_dirty_rect(src_rect, dst_rect, &dirty_rects[i], &s, &d))
+                continue;
+            if (!BitBlt(dst_dc, d.left, d.top, d.right - d.left, d.bottom - d.top, src_dc, s.left, s.top, SRCCOPY))
+                ERR("Failed to blit.\n");
+        }
+    }
+    else if (!StretchBlt(dst_dc, dst_rect->left, dst_rect->top, dst_rect->right - dst_rect->left,
             dst_rect->bottom - dst_rect->top, src_dc, src_rect->left, src_rect->top,
             src_rect->right - src_rect->left, src_rect->bottom - src_rect->top, SRCCOPY))
+    {
         ERR("Failed to blit.\n");
+    }
 
     ReleaseDC(swapchain->win_handle, dst_dc);
     destroy_desc.hDc = src_dc;
@@ -588,8 +634,8 @@ static bool swapchain_present_is_partial_copy(struct wined3d_swapchain *swapchai
     return false;
 }
 
-static void swapchain_gl_present(struct wined3d_swapchain *swapchain,
-        const RECT *src_rect, const RECT *dst_rect, unsigned int swap_interval, DWORD flags)
+static void swapchain_gl_present(struct wined3d_swapchain *swapchain, const RECT *src_rect, const RECT *dst_rect,
+        const RECT *dirty_rects, unsigned int dirty_rect_count, unsigned int swap_interval, DWORD flags)
 {
     struct wined3d_swapchain_gl *swapchain_gl = wined3d_swapchain_gl(swapchain);
     struct wined3d_texture *back_buffer = swapchain->back_buffers[0];
@@ -597,6 +643,8 @@ static void swapchain_gl_present(struct wined3d_swapchain *swapchain,
     const struct wined3d_gl_info *gl_info;
     struct wined3d_context_gl *context_gl;
     struct wined3d_context *context;
+    unsigned int i;
+    RECT s, d;
 
     context = context_acquire(swapchain->device, swapchain->front_buffer, 0);
     context_gl = wined3d_context_gl(context);
@@ -613,7 +661,7 @@ static void swapchain_gl_present(struct wined3d_swapchain *swapchain,
     if (context_gl->dc == swapchain_gl->backup_dc || (pixel_format->swap_method != WGL_SWAP_COPY_ARB
             && swapchain_present_is_partial_copy(swapchain, dst_rect)))
     {
-        swapchain_blit_gdi(swapchain, context, src_rect, dst_rect);
+        swapchain_blit_gdi(swapchain, context, src_rect, dst_rect, dirty_rects, dirty_rect_count);
     }
     else
     {
@@ -623,8 +671,22 @@ static void swapchain_gl_present(struct wined3d_swapchain *swapchain,
 
         wined3d_texture_load_location(back_buffer, 0, context, back_buffer->resource.draw_binding);
 
-        if (wined3d_settings.offscreen_rendering_mode == ORM_FBO)
+        /* The drawable back buffer only still contains the previous frame
+         * after a swap if the pixel format uses copy swaps. */
+        if (wined3d_settings.offscreen_rendering_mode == ORM_FBO && dirty_rect_count
+                && pixel_format->swap_method == WGL_SWAP_COPY_ARB
+                && !swapchain_present_is_scaled(src_rect, dst_rect))
+        {
+            for (i = 0; i < dirty_rect_count; ++i)
+            {
+                if (swapchain_get_dirty_rect(src_rect, dst_rect, &dirty_rects[i], &s, &d))
+                    swapchain_blit(swapchain, context, &s, &d);
+            }
+        }
+        else if (wined3d_settings.offscreen_rendering_mode == ORM_FBO)
+        {
             swapchain_blit(swapchain, context, src_rect, dst_rect);
+        }
 
         if (swapchain_gl->context_count > 1)
             gl_info->gl_ops.gl.p_glFinish();
@@ -1227,8 +1289,8 @@ static void wined3d_swapchain_vk_rotate(struct wined3d_swapchain *swapchain, str
     device_invalidate_state(swapchain->device, STATE_FRAMEBUFFER);
 }
 
-static void swapchain_vk_present(struct wined3d_swapchain *swapchain, const RECT *src_rect,
-        const RECT *dst_rect, unsigned int swap_interval, uint32_t flags)
+static void swapchain_vk_present(struct wined3d_swapchain *swapchain, const RECT *src_rect, const RECT *dst_rect,
+        const RECT *dirty_rects, unsigned int dirty_rect_count, unsigned int swap_interval, uint32_t flags)
 {
     struct wined3d_swapchain_vk *swapchain_vk = wined3d_swapchain_vk(swapchain);
     struct wined3d_texture *back_buffer = swapchain->back_buffers[0];
@@ -1240,7 +1302,7 @@ static void swapchain_vk_present(struct wined3d_swapchain *swapchain, const RECT
 
     if (!swapchain_vk->vk_swapchain || swapchain_present_is_partial_copy(swapchain, dst_rect))
     {
-        swapchain_blit_gdi(swapchain, &context_vk->c, src_rect, dst_rect);
+        swapchain_blit_gdi(swapchain, &context_vk->c, src_rect, dst_rect, dirty_rects, dirty_rect_count);
     }
     else
     {
@@ -1321,8 +1383,8 @@ static void swapchain_gdi_frontbuffer_updated(struct wined3d_swapchain *swapchai
     SetRectEmpty(&swapchain->front_buffer_update);
 }
 
-static void swapchain_gdi_present(struct wined3d_swapchain *swapchain,
-        const RECT *src_rect, const RECT *dst_rect, unsigned int swap_interval, DWORD flags)
+static void swapchain_gdi_present(struct wined3d_swapchain *swapchain, const RECT *src_rect, const RECT *dst_rect,
+        const RECT *dirty_rects, unsigned int dirty_rect_count, unsigned int swap_interval, DWORD flags)
 {
     struct wined3d_dc_info *front, *back;
     HBITMAP bitmap;
@@ -1557,6 +1557,9 @@ DWORD get_pixmap_image( Pixmap pixmap, int width, int height, const XVisualInfo
 }
 
 
+/* flush the bounding rectangle instead of the damage region above this many rectangles */
+#define MAX_DAMAGE_RECTS 16
+
 struct x11drv_window_surface
 {
     struct window_surface header;
@@ -1569,6 +1572,7 @@ struct x11drv_window_surface
     DWORD                 alpha_bits;
     COLORREF              color_key;
     HRGN                  region;
+    HRGN                  damage;   /* exposed areas not yet flushed */
     void                 *bits;
 #ifdef HAVE_LIBXXSHM
     XShmSegmentInfo       shminfo;
@@ -1887,68 +1891,142 @@ static void CDECL x11drv_surface_set_region( struct window_surface *window_surfa
 }
 
 /***********************************************************************
- *           x11drv_surface_flush
+ *           put_surface_rect
+ *
+ * Copy a rectangle of the surface bits to the image and send it to the X server.
  */
-static void CDECL x11drv_surface_flush( struct window_surface *window_surface )
+static void put_surface_rect( struct x11drv_window_surface *surface, const RECT *rect )
 {
-    struct x11drv_window_surface *surface = get_x11_surface( window_surface );
     unsigned char *src = surface->bits;
     unsigned char *dst = (unsigned char *)surface->image->data;
-    struct bitblt_coords coords;
 
-    window_surface->funcs->lock( window_surface );
-    coords.x = 0;
-    coords.y = 0;
-    coords.width  = surface->header.rect.right - surface->header.rect.left;
-    coords.height = surface->header.rect.bottom - surface->header.rect.top;
-    SetRect( &coords.visrect, 0, 0, coords.width, coords.height );
-    if (IntersectRect( &coords.visrect, &coords.visrect, &surface->bounds ))
+    if (src != dst)
+    {
+        int map[256], *mapping = get_window_surface_mapping( surface->image->bits_per_pixel, map );
+        int width_bytes = surface->image->bytes_per_line;
+
+        src += rect->top * width_bytes;
+        dst += rect->top * width_bytes;
+        copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
+                             rect->bottom - rect->top,
+                             surface->byteswap, mapping, ~0u, surface->alpha_bits );
+    }
+    else if (surface->alpha_bits)
     {
-        TRACE( "flushing %p %dx%d bounds %s bits %p\n",
-               surface, coords.width, coords.height,
-               wine_dbgstr_rect( &surface->bounds ), surface->bits );
+        int x, y, stride = surface->image->bytes_per_line / sizeof(ULONG);
+        ULONG *ptr = (ULONG *)dst + rect->top * stride;
 
-        if (surface->is_argb || surface->color_key != CLR_INVALID) update_surface_region( surface );
+        for (y = rect->top; y < rect->bottom; y++, ptr += stride)
+            for (x = rect->left; x < rect->right; x++)
+                ptr[x] |= surface->alpha_bits;
+    }
 
-        if (src != dst)
+#ifdef HAVE_LIBXXSHM
+    if (surface->shminfo.shmid != -1)
+        XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
+                      rect->left, rect->top,
+                      surface->header.rect.left + rect->left,
+                      surface->header.rect.top + rect->top,
+                      rect->right - rect->left, rect->bottom - rect->top, False );
+    else
+#endif
+    XPutImage( gdi_display, surface->window, surface->gc, surface->image,
+               rect->left, rect->top,
+               surface->header.rect.left + rect->left,
+               surface->header.rect.top + rect->top,
+               rect->right - rect->left, rect->bottom - rect->top );
+}
+
+/***********************************************************************
+ *           get_surface_damage
+ *
+ * Merge the drawing bounds into the pending damage region, clip it to the
+ * surface rectangle and return its rectangles. The damage region is reset.
+ */
+static RGNDATA *get_surface_damage( struct x11drv_window_surface *surface, const RECT *rect )
+{
+    RGNDATA *data;
+    DWORD size;
+    HRGN tmp;
+
+    if (!IsRectEmpty( &surface->bounds ))
+    {
+        tmp = CreateRectRgnIndirect( &surface->bounds );
+        CombineRgn( surface->damage, surface->damage, tmp, RGN_OR );
+        DeleteObject( tmp );
+    }
+    tmp = CreateRectRgnIndirect( rect );
+    CombineRgn( surface->damage, surface->damage, tmp, RGN_AND );
+    DeleteObject( tmp );
+
+    if ((size = GetRegionData( surface->damage, 0, NULL )) &&
+        (data = HeapAlloc( GetProcessHeap(), 0, size )))
+    {
+        if (!GetRegionData( surface->damage, size, data ))
         {
-            int map[256], *mapping = get_window_surface_mapping( surface->image->bits_per_pixel, map );
-            int width_bytes = surface->image->bytes_per_line;
-
-            src += coords.visrect.top * width_bytes;
-            dst += coords.visrect.top * width_bytes;
-            copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
-                                 coords.visrect.bottom - coords.visrect.top,
-                                 surface->byteswap, mapping, ~0u, surface->alpha_bits );
+            HeapFree( GetProcessHeap(), 0, data );
+            data = NULL;
         }
-        else if (surface->alpha_bits)
-        {
-            int x, y, stride = surface->image->bytes_per_line / sizeof(ULONG);
-            ULONG *ptr = (ULONG *)dst + coords.visrect.top * stride;
+    }
+    else data = NULL;
 
-            for (y = coords.visrect.top; y < coords.visrect.bottom; y++, ptr += stride)
-                for (x = coords.visrect.left; x < coords.visrect.right; x++)
-                    ptr[x] |= surface->alpha_bits;
-        }
+    DeleteObject( surface->damage );
+    surface->damage = 0;
+    return data;
+}
 
-#ifdef HAVE_LIBXXSHM
-        if (surface->shminfo.shmid != -1)
-            XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                          coords.visrect.left, coords.visrect.top,
-                          surface->header.rect.left + coords.visrect.left,
-                          surface->header.rect.top + coords.visrect.top,
-                          coords.visrect.right - coords.visrect.left,
-                          coords.visrect.bottom - coords.visrect.top, False );
+/***********************************************************************
+ *           x11drv_surface_flush
+ */
+static void CDECL x11drv_surface_flush( struct window_surface *window_surface )
+{
+    struct x11drv_window_surface *surface = get_x11_surface( window_surface );
+    RGNDATA *damage = NULL;
+    RECT rect, bounds, *rects = NULL;
+    DWORD i, count = 0;
+
+    window_surface->funcs->lock( window_surface );
+    SetRect( &rect, 0, 0, surface->header.rect.right - surface->header.rect.left,
+             surface->header.rect.bottom - surface->header.rect.top );
+
+    if (surface->damage)
+    {
+        /* only send the damaged rectangles, unless there are too many of them */
+        if (!(damage = get_surface_damage( surface, &rect )))
+        {
+            rects = &rect;
+            count = 1;
+        }
+        else if (damage->rdh.nCount <= MAX_DAMAGE_RECTS)
+        {
+            rects = (RECT *)damage->Buffer;
+            count = damage->rdh.nCount;
+        }
         else
-#endif
-        XPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                   coords.visrect.left, coords.visrect.top,
-                   surface->header.rect.left + coords.visrect.left,
-                   surface->header.rect.top + coords.visrect.top,
-                   coords.visrect.right - coords.visrect.left,
-                   coords.visrect.bottom - coords.visrect.top );
+        {
+            bounds = damage->rdh.rcBound;
+            rects = &bounds;
+            count = 1;
+        }
+    }
+    else if (IntersectRect( &bounds, &rect, &surface->bounds ))
+    {
+        rects = &bounds;
+        count = 1;
+    }
+
+    if (count)
+    {
+        TRACE( "flushing %p %dx%d bounds %s rects %u bits %p\n",
+               surface, rect.right, rect.bottom,
+               wine_dbgstr_rect( &surface->bounds ), count, surface->bits );
+
+        if (surface->is_argb || surface->color_key != CLR_INVALID) update_surface_region( surface );
+
+        for (i = 0; i < count; i++) put_surface_rect( surface, &rects[i] );
         XFlush( gdi_display );
     }
+    HeapFree( GetProcessHeap(), 0, damage );
     reset_bounds( &surface->bounds );
     window_surface->funcs->unlock( window_surface );
 }
@@ -1980,6 +2058,7 @@ static void CDECL x11drv_surface_destroy( struct window_surface *window_surface
     surface->crit.DebugInfo->Spare[0] = 0;
     DeleteCriticalSection( &surface->crit );
     if (surface->region) DeleteObject( surface->region );
+    if (surface->damage) DeleteObject( surface->damage );
     HeapFree( GetProcessHeap(), 0, surface );
 }
 
@@ -2096,7 +2175,13 @@ HRGN expose_surface( struct window_surface *window_surface, const RECT *rect )
 
     window_surface->funcs->lock( window_surface );
     OffsetRect( &rc, -window_surface->rect.left, -window_surface->rect.top );
-    add_bounds_rect( &surface->bounds, &rc );
+    if (!surface->damage) surface->damage = CreateRectRgnIndirect( &rc );
+    else
+    {
+        HRGN tmp = CreateRectRgnIndirect( &rc );
+        CombineRgn( surface->damage, surface->damage, tmp, RGN_OR );
+        DeleteObject( tmp );
+    }
     if (surface->region)
     {
         region = CreateRectRgnIndirect( rect );
@@ -284,6 +284,14 @@ static inline const char *debugstr_sockopt(int level, int optname)
         }
         break;
 
+        DEBUG_SOCKLEVEL(IPPROTO_UDP);
+        switch(optname)
+        {
+            DEBUG_SOCKOPT(UDP_SEND_MSG_SIZE);
+            DEBUG_SOCKOPT(UDP_RECV_MAX_COALESCED_SIZE);
+        }
+        break;
+
         DEBUG_SOCKLEVEL(IPPROTO_IP);
         switch(optname)
         {
@@ -1164,6 +1172,8 @@ int WINAPI bind( SOCKET s, const struct sockaddr *addr, int len )
 }
 
 
+static void rio_close_socket( SOCKET s );
+
 /***********************************************************************
  *      closesocket   (ws2_32.3)
  */
@@ -1183,6 +1193,7 @@ int WINAPI closesocket( SOCKET s )
         return -1;
     }
 
+    rio_close_socket( s );
     CloseHandle( (HANDLE)s );
     return 0;
 }
@@ -1315,6 +1326,572 @@ static BOOL WINAPI WS2_DisconnectEx( SOCKET s, OVERLAPPED *overlapped, DWORD fla
 }
 
 
+/* Registered I/O.
+ *
+ * Requests are submitted as regular overlapped receives and sends which
+ * bypass any completion port the socket is bound to, and signal an event
+ * private to the target completion queue instead.  Each completion queue
+ * keeps the list of its requests in flight; they are moved into its
+ * user-space ring either by RIODequeueCompletion() when the ring is empty
+ * or by a thread pool wait on the queue's event, so that dequeuing results
+ * never needs a server call when results are available.  Finished request
+ * structures are kept on the completion queue for reuse. */
+
+struct rio_buffer
+{
+    char *data;
+    DWORD len;
+};
+
+struct rio_cq
+{
+    CRITICAL_SECTION cs;
+    RIORESULT *results;
+    DWORD size;
+    DWORD head;
+    DWORD count;
+    BOOL corrupt;
+    BOOL armed;
+    RIO_NOTIFICATION_COMPLETION notify;
+    HANDLE event;
+    HANDLE wait;
+    struct list pending;
+    struct list free;
+};
+
+struct rio_rq
+{
+    struct list entry;
+    LONG refcount;
+    SOCKET socket;
+    void *context;
+    struct rio_cq *recv_cq;
+    struct rio_cq *send_cq;
+    LONG recv_pending;
+    LONG send_pending;
+    ULONG max_recv;
+    ULONG max_send;
+};
+
+struct rio_request
+{
+    OVERLAPPED ovl;
+    struct list entry;
+    struct rio_rq *rq;
+    void *context;
+    BOOL send;
+    BOOL notify;
+    BOOL submitted;
+    WSABUF buffer;
+    DWORD flags;
+    int addr_len;
+};
+
+static struct list rio_queues = LIST_INIT( rio_queues );
+DECLARE_CRITICAL_SECTION(cs_rio);
+
+static void rio_release_rq( struct rio_rq *rq )
+{
+    if (!InterlockedDecrement( &rq->refcount )) free( rq );
+}
+
+static void rio_cq_notify( struct rio_cq *cq )
+{
+    if (cq->notify.Type == RIO_EVENT_COMPLETION)
+        SetEvent( cq->notify.u.Event.EventHandle );
+    else
+        PostQueuedCompletionStatus( cq->notify.u.Iocp.IocpHandle, 0,
+                                    (ULONG_PTR)cq->notify.u.Iocp.CompletionKey, cq->notify.u.Iocp.Overlapped );
+}
+
+/* Move the requests of a completion queue whose I/O status block has been
+ * filled in to its ring. Called with the queue's lock held; returns TRUE if
+ * the queue's notification has to be fired. */
+static BOOL rio_dispatch_locked( struct rio_cq *cq )
+{
+    struct rio_request *req, *next;
+    BOOL fire = FALSE;
+
+    LIST_FOR_EACH_ENTRY_SAFE( req, next, &cq->pending, struct rio_request, entry )
+    {
+        struct rio_rq *rq = req->rq;
+        NTSTATUS status = req->ovl.Internal;
+
+        if (!req->submitted || status == STATUS_PENDING) continue;
+
+        if (cq->count == cq->size)
+        {
+            ERR( "completion queue %p overflow\n", cq );
+            cq->corrupt = TRUE;
+        }
+        else
+        {
+            RIORESULT *result = &cq->results[(cq->head + cq->count++) % cq->size];
+
+            result->Status = status ? NtStatusToWSAError( status ) : 0;
+            result->BytesTransferred = req->ovl.InternalHigh;
+            result->SocketContext = (ULONG_PTR)rq->context;
+            result->RequestContext = (ULONG_PTR)req->context;
+        }
+        if (req->notify && cq->armed)
+        {
+            cq->armed = FALSE;
+            fire = TRUE;
+        }
+
+        list_remove( &req->entry );
+        list_add_head( &cq->free, &req->entry );
+        InterlockedDecrement( req->send ? &rq->send_pending : &rq->recv_pending );
+        rio_release_rq( rq );
+    }
+    return fire;
+}
+
+static void rio_dispatch( struct rio_cq *cq )
+{
+    BOOL fire;
+
+    EnterCriticalSection( &cq->cs );
+    fire = rio_dispatch_locked( cq );
+    LeaveCriticalSection( &cq->cs );
+
+    if (fire) rio_cq_notify( cq );
+}
+
+static void CALLBACK rio_cq_wait_callback( void *context, BOOLEAN timeout )
+{
+    rio_dispatch( context );
+}
+
+static char *rio_buffer_data( const RIO_BUF *buf )
+{
+    struct rio_buffer *buffer = (struct rio_buffer *)buf->BufferId;
+
+    if (!buffer || buf->BufferId == RIO_INVALID_BUFFERID) return NULL;
+    if (buf->Offset > buffer->len || buf->Length > buffer->len - buf->Offset) return NULL;
+    return buffer->data + buf->Offset;
+}
+
+static struct rio_request *rio_alloc_request( struct rio_rq *rq, BOOL send, const RIO_BUF *data,
+                                              ULONG count, DWORD flags, void *context )
+{
+    LONG *pending = send ? &rq->send_pending : &rq->recv_pending;
+    struct rio_cq *cq = send ? rq->send_cq : rq->recv_cq;
+    ULONG max = send ? rq->max_send : rq->max_recv;
+    struct rio_request *req = NULL;
+    struct list *entry;
+
+    if (count > 1 || (count && !data))
+    {
+        SetLastError( WSAEINVAL );
+        return NULL;
+    }
+
+    if (InterlockedIncrement( pending ) > max)
+    {
+        InterlockedDecrement( pending );
+        SetLastError( WSAENOBUFS );
+        return NULL;
+    }
+
+    EnterCriticalSection( &cq->cs );
+    if ((entry = list_head( &cq->free )))
+    {
+        list_remove( entry );
+        req = LIST_ENTRY( entry, struct rio_request, entry );
+    }
+    LeaveCriticalSection( &cq->cs );
+
+    if (req) memset( req, 0, sizeof(*req) );
+    else if (!(req = calloc( 1, sizeof(*req) )))
+    {
+        InterlockedDecrement( pending );
+        SetLastError( WSAENOBUFS );
+        return NULL;
+    }
+    req->rq = rq;
+    req->context = context;
+    req->send = send;
+    req->notify = !(flags & RIO_MSG_DONT_NOTIFY);
+    if (count && !(req->buffer.buf = rio_buffer_data( data )))
+    {
+        free( req );
+        InterlockedDecrement( pending );
+        SetLastError( WSAEINVAL );
+        return NULL;
+    }
+    req->buffer.len = count ? data->Length : 0;
+    /* the low bit keeps the completion off any port the socket is bound to */
+    req->ovl.hEvent = (HANDLE)((ULONG_PTR)cq->event | 1);
+    InterlockedIncrement( &rq->refcount );
+
+    EnterCriticalSection( &cq->cs );
+    list_add_tail( &cq->pending, &req->entry );
+    LeaveCriticalSection( &cq->cs );
+    return req;
+}
+
+static BOOL rio_submit_result( struct rio_request *req, int ret )
+{
+    struct rio_rq *rq = req->rq;
+    struct rio_cq *cq = req->send ? rq->send_cq : rq->recv_cq;
+    DWORD err = GetLastError();
+    BOOL done;
+
+    if (!ret || err == WSA_IO_PENDING)
+    {
+        /* the dispatcher ignores the request until now, so it may have
+         * missed the event if the request already completed */
+        EnterCriticalSection( &cq->cs );
+        req->submitted = TRUE;
+        done = req->ovl.Internal != STATUS_PENDING;
+        LeaveCriticalSection( &cq->cs );
+        if (done) SetEvent( cq->event );
+        SetLastError( 0 );
+        return TRUE;
+    }
+
+    EnterCriticalSection( &cq->cs );
+    list_remove( &req->entry );
+    list_add_head( &cq->free, &req->entry );
+    LeaveCriticalSection( &cq->cs );
+    InterlockedDecrement( req->send ? &rq->send_pending : &rq->recv_pending );
+    rio_release_rq( rq );
+    SetLastError( err );
+    return FALSE;
+}
+
+/* Release the request queues of a socket which is being closed. Requests
+ * still in flight keep their queue alive until they complete. */
+static void rio_close_socket( SOCKET s )
+{
+    struct rio_rq *rq, *next;
+
+    EnterCriticalSection( &cs_rio );
+    LIST_FOR_EACH_ENTRY_SAFE( rq, next, &rio_queues, struct rio_rq, entry )
+    {
+        if (rq->socket != s) continue;
+        list_remove( &rq->entry );
+        rio_release_rq( rq );
+    }
+    LeaveCriticalSection( &cs_rio );
+}
+
+static BOOL WINAPI WS2_RIOReceiveEx( RIO_RQ queue, RIO_BUF *data, ULONG count, RIO_BUF *local_addr,
+                                     RIO_BUF *remote_addr, RIO_BUF *control, RIO_BUF *msg_flags,
+                                     DWORD flags, void *context )
+{
+    struct rio_rq *rq = (struct rio_rq *)queue;
+    struct sockaddr *addr = NULL;
+    struct rio_request *req;
+
+    TRACE( "queue %p, data %p, count %lu, local_addr %p, remote_addr %p, control %p, msg_flags %p, "
+           "flags %#lx, context %p\n", queue, data, count, local_addr, remote_addr, control, msg_flags,
+           flags, context );
+
+    if ((flags & RIO_MSG_COMMIT_ONLY) && !count) return TRUE;
+    if (local_addr || control || msg_flags)
+        FIXME( "local address, control and flags buffers are not supported\n" );
+
+    if (!(req = rio_alloc_request( rq, FALSE, data, count, flags, context ))) return FALSE;
+    if (remote_addr)
+    {
+        if (!(addr = (struct sockaddr *)rio_buffer_data( remote_addr )))
+        {
+            rio_submit_result( req, -1 );
+            SetLastError( WSAEINVAL );
+            return FALSE;
+        }
+        req->addr_len = remote_addr->Length;
+    }
+    if (flags & RIO_MSG_WAITALL) req->flags = MSG_WAITALL;
+
+    return rio_submit_result( req, WS2_recv_base( rq->socket, &req->buffer, 1, NULL, &req->flags,
+                                                  addr, addr ? &req->addr_len : NULL,
+                                                  &req->ovl, NULL, NULL ) );
+}
+
+static BOOL WINAPI WS2_RIOReceive( RIO_RQ queue, RIO_BUF *data, ULONG count, DWORD flags, void *context )
+{
+    return WS2_RIOReceiveEx( queue, data, count, NULL, NULL, NULL, NULL, flags, context );
+}
+
+static BOOL WINAPI WS2_RIOSendEx( RIO_RQ queue, RIO_BUF *data, ULONG count, RIO_BUF *local_addr,
+                                  RIO_BUF *remote_addr, RIO_BUF *control, RIO_BUF *msg_flags,
+                                  DWORD flags, void *context )
+{
+    struct rio_rq *rq = (struct rio_rq *)queue;
+    const struct sockaddr *addr = NULL;
+    struct rio_request *req;
+    int addr_len = 0;
+
+    TRACE( "queue %p, data %p, count %lu, local_addr %p, remote_addr %p, control %p, msg_flags %p, "
+           "flags %#lx, context %p\n", queue, data, count, local_addr, remote_addr, control, msg_flags,
+           flags, context );
+
+    if ((flags & RIO_MSG_COMMIT_ONLY) && !count) return TRUE;
+    if (local_addr || control || msg_flags)
+        FIXME( "local address, control and flags buffers are not supported\n" );
+
+    if (!(req = rio_alloc_request( rq, TRUE, data, count, flags, context ))) return FALSE;
+    if (remote_addr)
+    {
+        if (!(addr = (const struct sockaddr *)rio_buffer_data( remote_addr )))
+        {
+            rio_submit_result( req, -1 );
+            SetLastError( WSAEINVAL );
+            return FALSE;
+        }
+        addr_len = remote_addr->Length;
+    }
+
+    return rio_submit_result( req, WS2_sendto( rq->socket, &req->buffer, 1, NULL, 0,
+                                               addr, addr_len, &req->ovl, NULL ) );
+}
+
+static BOOL WINAPI WS2_RIOSend( RIO_RQ queue, RIO_BUF *data, ULONG count, DWORD flags, void *context )
+{
+    return WS2_RIOSendEx( queue, data, count, NULL, NULL, NULL, NULL, flags, context );
+}
+
+static RIO_CQ WINAPI WS2_RIOCreateCompletionQueue( DWORD size, RIO_NOTIFICATION_COMPLETION *notify )
+{
+    struct rio_cq *cq;
+
+    TRACE( "size %lu, notify %p\n", size, notify );
+
+    if (!size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_CQ;
+    }
+    if (notify && notify->Type != RIO_EVENT_COMPLETION && notify->Type != RIO_IOCP_COMPLETION)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_CQ;
+    }
+    if (!(cq = calloc( 1, sizeof(*cq) ))) goto error;
+    if (!(cq->results = malloc( size * sizeof(*cq->results) ))) goto error;
+    if (!(cq->event = CreateEventW( NULL, FALSE, FALSE, NULL ))) goto error;
+    InitializeCriticalSection( &cq->cs );
+    cq->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": rio_cq.cs");
+    list_init( &cq->pending );
+    list_init( &cq->free );
+    cq->size = size;
+    if (notify) cq->notify = *notify;
+    if (!RegisterWaitForSingleObject( &cq->wait, cq->event, rio_cq_wait_callback, cq, INFINITE, WT_EXECUTEDEFAULT ))
+    {
+        cq->cs.DebugInfo->Spare[0] = 0;
+        DeleteCriticalSection( &cq->cs );
+        goto error;
+    }
+    return (RIO_CQ)cq;
+
+error:
+    if (cq)
+    {
+        if (cq->event) CloseHandle( cq->event );
+        free( cq->results );
+        free( cq );
+    }
+    SetLastError( WSAENOBUFS );
+    return RIO_INVALID_CQ;
+}
+
+static BOOL WINAPI WS2_RIOResizeCompletionQueue( RIO_CQ queue, DWORD size )
+{
+    struct rio_cq *cq = (struct rio_cq *)queue;
+    RIORESULT *results;
+    DWORD i;
+
+    TRACE( "queue %p, size %lu\n", queue, size );
+
+    if (!size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &cq->cs );
+    if (size < cq->count)
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAETOOMANYREFS );
+        return FALSE;
+    }
+    if (!(results = malloc( size * sizeof(*results) )))
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    for (i = 0; i < cq->count; i++) results[i] = cq->results[(cq->head + i) % cq->size];
+    free( cq->results );
+    cq->results = results;
+    cq->size = size;
+    cq->head = 0;
+    LeaveCriticalSection( &cq->cs );
+    return TRUE;
+}
+
+static void WINAPI WS2_RIOCloseCompletionQueue( RIO_CQ queue )
+{
+    struct rio_cq *cq = (struct rio_cq *)queue;
+    struct rio_request *req, *next;
+
+    TRACE( "queue %p\n", queue );
+
+    if (!cq) return;
+    UnregisterWaitEx( cq->wait, INVALID_HANDLE_VALUE );
+    CloseHandle( cq->event );
+    LIST_FOR_EACH_ENTRY_SAFE( req, next, &cq->free, struct rio_request, entry )
+        free( req );
+    cq->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &cq->cs );
+    free( cq->results );
+    free( cq );
+}
+
+static ULONG WINAPI WS2_RIODequeueCompletion( RIO_CQ queue, RIORESULT *results, ULONG count )
+{
+    struct rio_cq *cq = (struct rio_cq *)queue;
+    ULONG i;
+
+    TRACE( "queue %p, results %p, count %lu\n", queue, results, count );
+
+    /* pick up anything already completed instead of waiting for the thread pool */
+    EnterCriticalSection( &cq->cs );
+    if (!cq->count)
+    {
+        LeaveCriticalSection( &cq->cs );
+        rio_dispatch( cq );
+        EnterCriticalSection( &cq->cs );
+    }
+    if (cq->corrupt)
+    {
+        LeaveCriticalSection( &cq->cs );
+        return RIO_CORRUPT_CQ;
+    }
+    count = min( count, cq->count );
+    for (i = 0; i < count; i++) results[i] = cq->results[(cq->head + i) % cq->size];
+    cq->head = (cq->head + count) % cq->size;
+    cq->count -= count;
+    LeaveCriticalSection( &cq->cs );
+    return count;
+}
+
+static INT WINAPI WS2_RIONotify( RIO_CQ queue )
+{
+    struct rio_cq *cq = (struct rio_cq *)queue;
+    BOOL fire = FALSE;
+
+    TRACE( "queue %p\n", queue );
+
+    if (!cq->notify.Type) return WSAEINVAL;
+
+    if (cq->notify.Type == RIO_EVENT_COMPLETION && cq->notify.u.Event.NotifyReset)
+        ResetEvent( cq->notify.u.Event.EventHandle );
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->armed)
+    {
+        LeaveCriticalSection( &cq->cs );
+        return WSAEALREADY;
+    }
+    if (cq->count) fire = TRUE;
+    else cq->armed = TRUE;
+    LeaveCriticalSection( &cq->cs );
+
+    if (fire) rio_cq_notify( cq );
+    return ERROR_SUCCESS;
+}
+
+static RIO_RQ WINAPI WS2_RIOCreateRequestQueue( SOCKET s, ULONG max_recv, ULONG max_recv_buffers,
+                                                ULONG max_send, ULONG max_send_buffers,
+                                                RIO_CQ recv_cq, RIO_CQ send_cq, void *context )
+{
+    struct rio_rq *rq;
+
+    TRACE( "socket %#Ix, max_recv %lu, max_recv_buffers %lu, max_send %lu, max_send_buffers %lu, "
+           "recv_cq %p, send_cq %p, context %p\n", s, max_recv, max_recv_buffers, max_send,
+           max_send_buffers, recv_cq, send_cq, context );
+
+    if (!recv_cq || !send_cq || max_recv_buffers > 1 || max_send_buffers > 1)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+    if (!socket_list_find( s ))
+    {
+        SetLastError( WSAENOTSOCK );
+        return RIO_INVALID_RQ;
+    }
+
+    if (!(rq = calloc( 1, sizeof(*rq) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    rq->refcount = 1;
+    rq->socket = s;
+    rq->context = context;
+    rq->recv_cq = (struct rio_cq *)recv_cq;
+    rq->send_cq = (struct rio_cq *)send_cq;
+    rq->max_recv = max_recv;
+    rq->max_send = max_send;
+
+    EnterCriticalSection( &cs_rio );
+    list_add_tail( &rio_queues, &rq->entry );
+    LeaveCriticalSection( &cs_rio );
+    return (RIO_RQ)rq;
+}
+
+static BOOL WINAPI WS2_RIOResizeRequestQueue( RIO_RQ queue, DWORD max_recv, DWORD max_send )
+{
+    struct rio_rq *rq = (struct rio_rq *)queue;
+
+    TRACE( "queue %p, max_recv %lu, max_send %lu\n", queue, max_recv, max_send );
+
+    if (max_recv < rq->recv_pending || max_send < rq->send_pending)
+    {
+        SetLastError( WSAETOOMANYREFS );
+        return FALSE;
+    }
+    rq->max_recv = max_recv;
+    rq->max_send = max_send;
+    return TRUE;
+}
+
+static RIO_BUFFERID WINAPI WS2_RIORegisterBuffer( char *data, DWORD len )
+{
+    struct rio_buffer *buffer;
+
+    TRACE( "data %p, len %lu\n", data, len );
+
+    if (!data || !len)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_BUFFERID;
+    }
+    if (!(buffer = malloc( sizeof(*buffer) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_BUFFERID;
+    }
+    buffer->data = data;
+    buffer->len = len;
+    return (RIO_BUFFERID)buffer;
+}
+
+static void WINAPI WS2_RIODeregisterBuffer( RIO_BUFFERID id )
+{
+    TRACE( "id %p\n", id );
+
+    if (id == RIO_INVALID_BUFFERID) return;
+    free( id );
+}
+
+
 /***********************************************************************
  *      getpeername   (ws2_32.5)
  */
@@ -1739,6 +2316,33 @@ int WINAPI getsockopt( SOCKET s, int level, int optname, char *optval, int *optl
             return -1;
         }
 
+    case IPPROTO_UDP:
+        switch(optname)
+        {
+        case UDP_SEND_MSG_SIZE:
+            if (*optlen < sizeof(DWORD) || !optval)
+            {
+                *optlen = 0;
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            return server_getsockopt( s, IOCTL_AFD_WINE_GET_UDP_SEND_MSG_SIZE, optval, optlen );
+
+        case UDP_RECV_MAX_COALESCED_SIZE:
+            if (*optlen < sizeof(DWORD) || !optval)
+            {
+                *optlen = 0;
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            return server_getsockopt( s, IOCTL_AFD_WINE_GET_UDP_RECV_MAX_COALESCED_SIZE, optval, optlen );
+
+        default:
+            FIXME( "unrecognized UDP option %#x\n", optname );
+            SetLastError( WSAENOPROTOOPT );
+            return -1;
+        }
+
     case IPPROTO_IP:
         switch(optname)
         {
@@ -1943,6 +2547,7 @@ static const char *debugstr_wsaioctl(DWORD code)
         IOCTL_NAME(SIO_GET_EXTENSION_FUNCTION_POINTER);
         IOCTL_NAME(SIO_GET_GROUP_QOS);
         IOCTL_NAME(SIO_GET_INTERFACE_LIST);
+        IOCTL_NAME(SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER);
         /* IOCTL_NAME(SIO_GET_INTERFACE_LIST_EX); */
         IOCTL_NAME(SIO_GET_QOS);
         IOCTL_NAME(SIO_IDEAL_SEND_BACKLOG_CHANGE);
@@ -2277,6 +2882,52 @@ INT WINAPI WSAIoctl(SOCKET s, DWORD code, LPVOID in_buff, DWORD in_size, LPVOID
         return -1;
     }
 
+    case SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER:
+    {
+        static const GUID rio_guid = WSAID_MULTIPLE_RIO;
+        static const RIO_EXTENSION_FUNCTION_TABLE rio_table =
+        {
+            sizeof(RIO_EXTENSION_FUNCTION_TABLE),
+            WS2_RIOReceive,
+            WS2_RIOReceiveEx,
+            WS2_RIOSend,
+            WS2_RIOSendEx,
+            WS2_RIOCloseCompletionQueue,
+            WS2_RIOCreateCompletionQueue,
+            WS2_RIOCreateRequestQueue,
+            WS2_RIODequeueCompletion,
+            WS2_RIODeregisterBuffer,
+            WS2_RIONotify,
+            WS2_RIORegisterBuffer,
+            WS2_RIOResizeCompletionQueue,
+            WS2_RIOResizeRequestQueue,
+        };
+        NTSTATUS status = STATUS_SUCCESS;
+        DWORD ret;
+
+        if (!in_buff || in_size < sizeof(GUID) || !IsEqualGUID( &rio_guid, in_buff ))
+        {
+            FIXME( "SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER %s: stub\n",
+                   in_buff && in_size >= sizeof(GUID) ? debugstr_guid(in_buff) : "(null)" );
+            SetLastError( WSAEINVAL );
+            return -1;
+        }
+        if (!out_buff || out_size < sizeof(rio_table))
+        {
+            SetLastError( WSAEFAULT );
+            return -1;
+        }
+
+        TRACE( "returning RIO function table\n" );
+        memcpy( out_buff, &rio_table, sizeof(rio_table) );
+
+        ret = server_ioctl_sock( s, IOCTL_AFD_WINE_COMPLETE_ASYNC, &status, sizeof(status),
+                                 NULL, 0, ret_size, overlapped, completion );
+        *ret_size = sizeof(rio_table);
+        SetLastError( ret );
+        return ret ? -1 : 0;
+    }
+
     case SIO_KEEPALIVE_VALS:
     {
         DWORD ret;
@@ -3085,6 +3736,32 @@ int WINAPI setsockopt( SOCKET s, int level, int optname, const char *optval, int
         }
         break;
 
+    case IPPROTO_UDP:
+        switch(optname)
+        {
+        case UDP_SEND_MSG_SIZE:
+            if (optlen < sizeof(DWORD) || !optval)
+            {
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            return server_setsockopt( s, IOCTL_AFD_WINE_SET_UDP_SEND_MSG_SIZE, optval, optlen );
+
+        case UDP_RECV_MAX_COALESCED_SIZE:
+            if (optlen < sizeof(DWORD) || !optval)
+            {
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            return server_setsockopt( s, IOCTL_AFD_WINE_SET_UDP_RECV_MAX_COALESCED_SIZE, optval, optlen );
+
+        default:
+            FIXME("Unknown IPPROTO_UDP optname 0x%08x\n", optname);
+            SetLastError(WSAENOPROTOOPT);
+            return SOCKET_ERROR;
+        }
+        break;
+
     case IPPROTO_IP:
         if (optlen < 0)
         {
@@ -777,6 +777,116 @@ static DWORD WINAPI poll_exclusive_thread_cb(void *param)
 #define POLL_SOCK_CNT 2
 #define POLL_CNT 4
 
+static void test_poll_mixed(void)
+{
+    const struct sockaddr_in bind_addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    char in_buffer[offsetof(struct afd_poll_params, sockets[3])];
+    char out_buffer[offsetof(struct afd_poll_params, sockets[3])];
+    struct afd_poll_params *in_params = (struct afd_poll_params *)in_buffer;
+    struct afd_poll_params *out_params = (struct afd_poll_params *)out_buffer;
+    SOCKET client, server, listener, connector, idle;
+    struct sockaddr_in addr;
+    IO_STATUS_BLOCK io;
+    HANDLE event;
+    int ret, len;
+
+    event = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ret = bind(listener, (const struct sockaddr *)&bind_addr, sizeof(bind_addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = listen(listener, 1);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(listener, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    tcp_socketpair(&client, &server);
+    ret = send(client, "data", 5, 0);
+    ok(ret == 5, "got %d\n", ret);
+    check_poll_mask(server, event, AFD_POLL_READ, AFD_POLL_READ);
+
+    /* An unconnected stream socket can't be polled by the client side, so the
+     * whole request has to go to the server, even though the other sockets
+     * could be answered without it. */
+    idle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    in_params->timeout = 0;
+    in_params->count = 2;
+    in_params->exclusive = FALSE;
+    in_params->sockets[0].socket = server;
+    in_params->sockets[0].flags = ~0;
+    in_params->sockets[0].status = 0xdeadbeef;
+    in_params->sockets[1].socket = idle;
+    in_params->sockets[1].flags = AFD_POLL_READ | AFD_POLL_ACCEPT | AFD_POLL_OOB;
+    in_params->sockets[1].status = 0xdeadbeef;
+
+    memset(out_buffer, 0xcc, sizeof(out_buffer));
+    ret = NtDeviceIoControlFile((HANDLE)server, event, NULL, NULL, &io, IOCTL_AFD_POLL,
+            in_params, offsetof(struct afd_poll_params, sockets[2]), out_params, sizeof(out_buffer));
+    ok(!ret, "got %#x\n", ret);
+    ok(!io.Status, "got %#lx\n", io.Status);
+    ok(io.Information == offsetof(struct afd_poll_params, sockets[1]), "got %#Ix\n", io.Information);
+    ok(out_params->count == 1, "got count %u\n", out_params->count);
+    ok(out_params->sockets[0].socket == server, "got socket %#Ix\n", out_params->sockets[0].socket);
+    ok(out_params->sockets[0].flags == (AFD_POLL_READ | AFD_POLL_WRITE | AFD_POLL_CONNECT),
+            "got flags %#x\n", out_params->sockets[0].flags);
+    ok(!out_params->sockets[0].status, "got status %#x\n", out_params->sockets[0].status);
+
+    /* Signaled sockets are reported in the order they were passed in, whichever
+     * side answers. */
+    connector = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ret = connect(connector, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    in_params->count = 3;
+    in_params->sockets[0].socket = listener;
+    in_params->sockets[0].flags = ~0;
+    in_params->sockets[1].socket = idle;
+    in_params->sockets[2].socket = server;
+    in_params->sockets[2].flags = ~0;
+    in_params->sockets[2].status = 0xdeadbeef;
+
+    memset(out_buffer, 0xcc, sizeof(out_buffer));
+    ret = NtDeviceIoControlFile((HANDLE)listener, event, NULL, NULL, &io, IOCTL_AFD_POLL,
+            in_params, sizeof(in_buffer), out_params, sizeof(out_buffer));
+    ok(!ret, "got %#x\n", ret);
+    ok(!io.Status, "got %#lx\n", io.Status);
+    ok(io.Information == offsetof(struct afd_poll_params, sockets[2]), "got %#Ix\n", io.Information);
+    ok(out_params->count == 2, "got count %u\n", out_params->count);
+    ok(out_params->sockets[0].socket == listener, "got socket %#Ix\n", out_params->sockets[0].socket);
+    ok(out_params->sockets[0].flags == AFD_POLL_ACCEPT, "got flags %#x\n", out_params->sockets[0].flags);
+    ok(!out_params->sockets[0].status, "got status %#x\n", out_params->sockets[0].status);
+    ok(out_params->sockets[1].socket == server, "got socket %#Ix\n", out_params->sockets[1].socket);
+    ok(out_params->sockets[1].flags == (AFD_POLL_READ | AFD_POLL_WRITE | AFD_POLL_CONNECT),
+            "got flags %#x\n", out_params->sockets[1].flags);
+    ok(!out_params->sockets[1].status, "got status %#x\n", out_params->sockets[1].status);
+
+    /* Without the idle socket the same poll can be answered on the client side. */
+    in_params->count = 2;
+    in_params->sockets[1] = in_params->sockets[2];
+
+    memset(out_buffer, 0xcc, sizeof(out_buffer));
+    ret = NtDeviceIoControlFile((HANDLE)listener, event, NULL, NULL, &io, IOCTL_AFD_POLL,
+            in_params, offsetof(struct afd_poll_params, sockets[2]), out_params, sizeof(out_buffer));
+    ok(!ret, "got %#x\n", ret);
+    ok(!io.Status, "got %#lx\n", io.Status);
+    ok(io.Information == offsetof(struct afd_poll_params, sockets[2]), "got %#Ix\n", io.Information);
+    ok(out_params->count == 2, "got count %u\n", out_params->count);
+    ok(out_params->sockets[0].socket == listener, "got socket %#Ix\n", out_params->sockets[0].socket);
+    ok(out_params->sockets[0].flags == AFD_POLL_ACCEPT, "got flags %#x\n", out_params->sockets[0].flags);
+    ok(out_params->sockets[1].socket == server, "got socket %#Ix\n", out_params->sockets[1].socket);
+    ok(out_params->sockets[1].flags == (AFD_POLL_READ | AFD_POLL_WRITE | AFD_POLL_CONNECT),
+            "got flags %#x\n", out_params->sockets[1].flags);
+
+    closesocket(connector);
+    closesocket(idle);
+    closesocket(client);
+    closesocket(server);
+    closesocket(listener);
+    CloseHandle(event);
+}
+
 static void test_poll_exclusive(void)
 {
     char in_buffer[offsetof(struct afd_poll_params, sockets[POLL_SOCK_CNT + 1])];
@@ -1766,6 +1876,85 @@ static void test_get_events(void)
     CloseHandle(event);
 }
 
+static void test_accept_order(void)
+{
+    const struct sockaddr_in bind_addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    GUID acceptex_guid = WSAID_ACCEPTEX;
+    SOCKET listener, acceptor, client, server;
+    char buffer[2 * (sizeof(struct sockaddr_in) + 16)];
+    LPFN_ACCEPTEX pAcceptEx;
+    struct sockaddr_in addr;
+    OVERLAPPED overlapped = {0};
+    DWORD size;
+    int ret, len;
+
+    listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ret = WSAIoctl(listener, SIO_GET_EXTENSION_FUNCTION_POINTER, &acceptex_guid, sizeof(acceptex_guid),
+            &pAcceptEx, sizeof(pAcceptEx), &size, NULL, NULL);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = bind(listener, (const struct sockaddr *)&bind_addr, sizeof(bind_addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = listen(listener, 2);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(listener, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    set_blocking(listener, FALSE);
+
+    /* A connection goes to an AcceptEx() queued before it arrived, even if
+     * accept() is called before the AcceptEx() request completes. */
+
+    overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    acceptor = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ret = pAcceptEx(listener, acceptor, buffer, 0, sizeof(struct sockaddr_in) + 16,
+            sizeof(struct sockaddr_in) + 16, &size, &overlapped);
+    ok(!ret, "AcceptEx succeeded\n");
+    ok(WSAGetLastError() == ERROR_IO_PENDING, "got error %u\n", WSAGetLastError());
+
+    client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ret = connect(client, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    server = accept(listener, NULL, NULL);
+    ok(server == INVALID_SOCKET, "expected failure\n");
+    ok(WSAGetLastError() == WSAEWOULDBLOCK, "got error %u\n", WSAGetLastError());
+    if (server != INVALID_SOCKET) closesocket(server);
+
+    ret = WaitForSingleObject(overlapped.hEvent, 1000);
+    ok(!ret, "wait timed out\n");
+    ret = GetOverlappedResult((HANDLE)listener, &overlapped, &size, FALSE);
+    ok(ret, "got error %lu\n", GetLastError());
+
+    ret = send(client, "data", 5, 0);
+    ok(ret == 5, "got %d\n", ret);
+    ret = recv(acceptor, buffer, sizeof(buffer), 0);
+    ok(ret == 5, "got %d\n", ret);
+    ok(!strcmp(buffer, "data"), "got %s\n", debugstr_an(buffer, ret));
+
+    closesocket(acceptor);
+    closesocket(client);
+
+    /* Without a queued AcceptEx(), accept() takes the connection. */
+
+    client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ret = connect(client, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    server = accept(listener, NULL, NULL);
+    ok(server != INVALID_SOCKET, "got error %u\n", WSAGetLastError());
+    set_blocking(server, TRUE);
+
+    ret = send(client, "data", 5, 0);
+    ok(ret == 5, "got %d\n", ret);
+    ret = recv(server, buffer, sizeof(buffer), 0);
+    ok(ret == 5, "got %d\n", ret);
+
+    closesocket(server);
+    closesocket(client);
+    closesocket(listener);
+    CloseHandle(overlapped.hEvent);
+}
+
 static void test_bind(void)
 {
     const struct sockaddr_in6 bind_addr6 = {.sin6_family = AF_INET6, .sin6_addr.s6_words = {0, 0, 0, 0, 0, 0, 0, htons(1)}};
@@ -2105,11 +2294,13 @@ START_TEST(afd)
 
     test_open_device();
     test_poll();
+    test_poll_mixed();
     test_poll_exclusive();
     test_poll_completion_port();
     test_recv();
     test_event_select();
     test_get_events();
+    test_accept_order();
     test_bind();
     test_getsockname();
 
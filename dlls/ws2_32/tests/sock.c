@@ -4996,6 +4996,150 @@ static void test_get_extension_func(void)
     closesocket(s);
 }
 
+static void test_rio(void)
+{
+    static const char data[] = "registered";
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    RIO_NOTIFICATION_COMPLETION notify = {0};
+    GUID rio_guid = WSAID_MULTIPLE_RIO;
+    RIO_EXTENSION_FUNCTION_TABLE rio;
+    RIO_BUF recv_buf, send_buf;
+    RIO_BUFFERID buffer_id;
+    SOCKET client, server;
+    OVERLAPPED *overlapped;
+    RIORESULT results[2];
+    ULONG_PTR key;
+    HANDLE port;
+    RIO_CQ cq;
+    RIO_RQ rq;
+    char buffer[64];
+    HANDLE event;
+    int ret, len;
+    DWORD size;
+
+    server = WSASocketA(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, WSA_FLAG_OVERLAPPED | WSA_FLAG_REGISTERED_IO);
+    ok(server != INVALID_SOCKET, "got error %u\n", WSAGetLastError());
+
+    memset(&rio, 0, sizeof(rio));
+    ret = WSAIoctl(server, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER, &rio_guid, sizeof(GUID),
+            &rio, sizeof(rio) - 1, &size, NULL, NULL);
+    ok(ret == -1, "expected failure\n");
+    ok(WSAGetLastError() == WSAEFAULT, "got error %u\n", WSAGetLastError());
+
+    size = 0xdeadbeef;
+    ret = WSAIoctl(server, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER, &rio_guid, sizeof(GUID),
+            &rio, sizeof(rio), &size, NULL, NULL);
+    if (ret)
+    {
+        win_skip("registered I/O is not supported, error %u\n", WSAGetLastError());
+        closesocket(server);
+        return;
+    }
+    ok(size == sizeof(rio), "got size %lu\n", size);
+    ok(rio.cbSize == sizeof(rio), "got cbSize %lu\n", rio.cbSize);
+
+    ret = bind(server, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(server, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ret = connect(client, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    buffer_id = rio.RIORegisterBuffer(buffer, sizeof(buffer));
+    ok(buffer_id != RIO_INVALID_BUFFERID, "got error %u\n", WSAGetLastError());
+
+    event = CreateEventW(NULL, TRUE, FALSE, NULL);
+    notify.Type = RIO_EVENT_COMPLETION;
+    notify.Event.EventHandle = event;
+    notify.Event.NotifyReset = TRUE;
+    cq = rio.RIOCreateCompletionQueue(4, &notify);
+    ok(cq != RIO_INVALID_CQ, "got error %u\n", WSAGetLastError());
+
+    /* a completion port bound to the socket doesn't get the RIO completions */
+    port = CreateIoCompletionPort((HANDLE)server, NULL, 0, 0);
+    ok(!!port, "got error %lu\n", GetLastError());
+
+    rq = rio.RIOCreateRequestQueue(server, 1, 1, 1, 1, cq, cq, (void *)0x1234);
+    ok(rq != RIO_INVALID_RQ, "got error %u\n", WSAGetLastError());
+
+    ret = rio.RIODequeueCompletion(cq, results, ARRAY_SIZE(results));
+    ok(!ret, "got %d results\n", ret);
+
+    recv_buf.BufferId = buffer_id;
+    recv_buf.Offset = 0;
+    recv_buf.Length = 32;
+    ret = rio.RIOReceive(rq, &recv_buf, 1, 0, (void *)0x5678);
+    ok(ret, "got error %u\n", WSAGetLastError());
+
+    WSASetLastError(0xdeadbeef);
+    ret = rio.RIOReceive(rq, &recv_buf, 1, 0, (void *)0x5678);
+    ok(!ret, "expected failure\n");
+    ok(WSAGetLastError() == WSAENOBUFS, "got error %u\n", WSAGetLastError());
+
+    ret = rio.RIONotify(cq);
+    ok(!ret, "got error %d\n", ret);
+    ret = rio.RIONotify(cq);
+    ok(ret == WSAEALREADY, "got error %d\n", ret);
+
+    ret = send(client, data, sizeof(data), 0);
+    ok(ret == sizeof(data), "got %d\n", ret);
+
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "wait timed out\n");
+
+    memset(results, 0xcc, sizeof(results));
+    ret = rio.RIODequeueCompletion(cq, results, ARRAY_SIZE(results));
+    ok(ret == 1, "got %d results\n", ret);
+    ok(!results[0].Status, "got status %ld\n", results[0].Status);
+    ok(results[0].BytesTransferred == sizeof(data), "got size %lu\n", results[0].BytesTransferred);
+    ok(results[0].SocketContext == 0x1234, "got socket context %#I64x\n", results[0].SocketContext);
+    ok(results[0].RequestContext == 0x5678, "got request context %#I64x\n", results[0].RequestContext);
+    ok(!strcmp(buffer, data), "got data %s\n", debugstr_a(buffer));
+
+    ret = GetQueuedCompletionStatus(port, &size, &key, &overlapped, 0);
+    ok(!ret, "expected failure\n");
+    ok(GetLastError() == WAIT_TIMEOUT, "got error %lu\n", GetLastError());
+
+    len = sizeof(addr);
+    ret = getsockname(client, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    memcpy(buffer + 32, &addr, sizeof(addr));
+
+    send_buf.BufferId = buffer_id;
+    send_buf.Offset = 0;
+    send_buf.Length = sizeof(data);
+    recv_buf.Offset = 32;
+    recv_buf.Length = sizeof(addr);
+    ret = rio.RIOSendEx(rq, &send_buf, 1, NULL, &recv_buf, NULL, NULL, 0, (void *)0x9abc);
+    ok(ret, "got error %u\n", WSAGetLastError());
+
+    memset(buffer, 0, 32);
+    ret = recv(client, buffer, 32, 0);
+    ok(ret == sizeof(data), "got %d\n", ret);
+    ok(!strcmp(buffer, data), "got data %s\n", debugstr_a(buffer));
+
+    ret = rio.RIONotify(cq);
+    ok(!ret, "got error %d\n", ret);
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "wait timed out\n");
+
+    ret = rio.RIODequeueCompletion(cq, results, ARRAY_SIZE(results));
+    ok(ret == 1, "got %d results\n", ret);
+    ok(!results[0].Status, "got status %ld\n", results[0].Status);
+    ok(results[0].BytesTransferred == sizeof(data), "got size %lu\n", results[0].BytesTransferred);
+    ok(results[0].RequestContext == 0x9abc, "got request context %#I64x\n", results[0].RequestContext);
+
+    closesocket(client);
+    closesocket(server);
+    rio.RIOCloseCompletionQueue(cq);
+    rio.RIODeregisterBuffer(buffer_id);
+    CloseHandle(event);
+    CloseHandle(port);
+}
+
 static void test_base_handle(void)
 {
     OVERLAPPED overlapped = {0}, *overlapped_ptr;
@@ -8465,8 +8609,13 @@ static void test_TransmitFile(void)
     TRANSMIT_FILE_BUFFERS buffers;
     SOCKET client, server, dest;
     WSAOVERLAPPED ov;
+    char temp_path[MAX_PATH], temp_name[MAX_PATH];
+    const DWORD big_size = 300000;
+    HANDLE big_file;
+    char *big_data, *recv_data;
     char buf[256];
     int iret, len;
+    DWORD i;
     BOOL bret;
 
     memset( &ov, 0, sizeof(ov) );
@@ -8614,6 +8763,70 @@ static void test_TransmitFile(void)
     ok(memcmp(buf, &footer_msg[0], sizeof(footer_msg)) == 0,
        "TransmitFile footer buffer did not match!\n");
 
+    /* Test a file larger than the socket buffers, with a start offset and a
+     * length; the file pointer must not move */
+    GetTempPathA(MAX_PATH, temp_path);
+    GetTempFileNameA(temp_path, "wst", 0, temp_name);
+    big_file = CreateFileA(temp_name, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                           FILE_FLAG_DELETE_ON_CLOSE, NULL);
+    ok(big_file != INVALID_HANDLE_VALUE, "failed to create file, error %lu\n", GetLastError());
+    big_data = malloc(big_size);
+    recv_data = malloc(big_size);
+    for (i = 0; i < big_size; ++i)
+        big_data[i] = i * 7 + i / 251;
+    bret = WriteFile(big_file, big_data, big_size, &num_bytes, NULL);
+    ok(bret && num_bytes == big_size, "failed to write file, error %lu\n", GetLastError());
+    iret = set_blocking(dest, TRUE);
+    ok(!iret, "failed to set blocking, error %lu\n", GetLastError());
+
+    ov.hEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    SetFilePointer(big_file, 5, NULL, FILE_BEGIN);
+    ov.Offset = 4097;
+    bret = pTransmitFile(client, big_file, 200000, 0, &ov, NULL, 0);
+    err = WSAGetLastError();
+    ok(!bret, "TransmitFile succeeded unexpectedly.\n");
+    ok(err == ERROR_IO_PENDING, "TransmitFile triggered unexpected errno (%ld != %d)\n", err, ERROR_IO_PENDING);
+    iret = do_synchronous_recv(dest, recv_data, 200000, 0, 200000);
+    ok(iret == 200000, "got %d bytes\n", iret);
+    ok(!memcmp(recv_data, big_data + ov.Offset, 200000), "TransmitFile data did not match!\n");
+    iret = WaitForSingleObject(ov.hEvent, 2000);
+    ok(iret == WAIT_OBJECT_0, "Overlapped TransmitFile failed.\n");
+    WSAGetOverlappedResult(client, &ov, &total_sent, FALSE, NULL);
+    ok(total_sent == 200000, "Overlapped TransmitFile sent an unexpected number of bytes (%ld != 200000).\n", total_sent);
+    num_bytes = SetFilePointer(big_file, 0, NULL, FILE_CURRENT);
+    ok(num_bytes == 5, "got file pointer %lu\n", num_bytes);
+
+    /* Without an OVERLAPPED, the transfer starts at the file pointer and
+     * moves it */
+    SetFilePointer(big_file, 1000, NULL, FILE_BEGIN);
+    bret = pTransmitFile(client, big_file, 20000, 0, NULL, NULL, 0);
+    ok(bret, "TransmitFile failed unexpectedly, error %lu\n", GetLastError());
+    iret = do_synchronous_recv(dest, recv_data, 20000, 0, 20000);
+    ok(iret == 20000, "got %d bytes\n", iret);
+    ok(!memcmp(recv_data, big_data + 1000, 20000), "TransmitFile data did not match!\n");
+    num_bytes = SetFilePointer(big_file, 0, NULL, FILE_CURRENT);
+    ok(num_bytes == 21000, "got file pointer %lu\n", num_bytes);
+
+    /* A length past the end of the file stops at the end of the file */
+    ov.Offset = big_size - 1000;
+    bret = pTransmitFile(client, big_file, 5000, 0, &ov, NULL, 0);
+    err = WSAGetLastError();
+    ok(!bret, "TransmitFile succeeded unexpectedly.\n");
+    ok(err == ERROR_IO_PENDING, "TransmitFile triggered unexpected errno (%ld != %d)\n", err, ERROR_IO_PENDING);
+    iret = WaitForSingleObject(ov.hEvent, 2000);
+    ok(iret == WAIT_OBJECT_0, "Overlapped TransmitFile failed.\n");
+    WSAGetOverlappedResult(client, &ov, &total_sent, FALSE, NULL);
+    ok(total_sent == 1000, "Overlapped TransmitFile sent an unexpected number of bytes (%ld != 1000).\n", total_sent);
+    iret = do_synchronous_recv(dest, recv_data, 1000, 0, 1000);
+    ok(iret == 1000, "got %d bytes\n", iret);
+    ok(!memcmp(recv_data, big_data + ov.Offset, 1000), "TransmitFile data did not match!\n");
+
+    CloseHandle(big_file);
+
+    free(recv_data);
+    free(big_data);
+    closesocket(dest);
+
     /* Test TransmitFile with a UDP datagram socket */
     closesocket(client);
     client = socket(AF_INET, SOCK_DGRAM, 0);
@@ -11978,6 +12191,49 @@ static void test_so_debug(void)
     closesocket(s);
 }
 
+static void test_udp_offload(void)
+{
+    int ret, len;
+    DWORD value;
+    SOCKET s;
+
+    s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    value = 1000;
+    ret = setsockopt(s, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (char *)&value, sizeof(value));
+    if (ret)
+    {
+        win_skip("UDP segmentation offload is not supported, error %u\n", WSAGetLastError());
+        closesocket(s);
+        return;
+    }
+
+    len = sizeof(value);
+    value = 0xdeadbeef;
+    ret = getsockopt(s, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (char *)&value, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ok(len == sizeof(value), "got len %u\n", len);
+    ok(value == 1000, "got size %lu\n", value);
+
+    value = 0;
+    ret = setsockopt(s, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (char *)&value, sizeof(value));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    len = sizeof(value);
+    value = 0xdeadbeef;
+    ret = getsockopt(s, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (char *)&value, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ok(!value, "got size %lu\n", value);
+
+    len = sizeof(value);
+    value = 0xdeadbeef;
+    ret = getsockopt(s, IPPROTO_UDP, UDP_RECV_MAX_COALESCED_SIZE, (char *)&value, &len);
+    ok(!ret || broken(WSAGetLastError() == WSAENOPROTOOPT), "got error %u\n", WSAGetLastError());
+    if (!ret) ok(!value, "got size %lu\n", value);
+
+    closesocket(s);
+}
+
 struct sockopt_validity_test
 {
     int opt;
@@ -12320,6 +12576,7 @@ START_TEST( sock )
     test_ipv6_cmsg();
     test_extendedSocketOptions();
     test_so_debug();
+    test_udp_offload();
     test_sockopt_validity();
 
     for (i = 0; i < ARRAY_SIZE(tests); i++)
@@ -12342,6 +12599,7 @@ START_TEST( sock )
     test_fionbio();
     test_fionread_siocatmark();
     test_get_extension_func();
+    test_rio();
     test_get_interface_list();
     test_keepalive_vals();
     test_sioRoutingInterfaceQuery();
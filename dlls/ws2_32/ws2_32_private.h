@@ -52,6 +52,7 @@
 #include "windns.h"
 #include "wine/afd.h"
 #include "wine/debug.h"
+#include "wine/list.h"
 #include "wine/unixlib.h"
 
 #define DECLARE_CRITICAL_SECTION(cs) \
@@ -1797,6 +1797,22 @@ struct send_socket_reply
 
 
 
+struct register_accepted_socket_request
+{
+    struct request_header __header;
+    obj_handle_t listen;
+    int          fd;
+    char __pad_20[4];
+};
+struct register_accepted_socket_reply
+{
+    struct reply_header __header;
+    obj_handle_t handle;
+    char __pad_12[4];
+};
+
+
+
 struct get_next_console_request_request
 {
     struct request_header __header;
@@ -2040,6 +2056,38 @@ struct list_processes_reply
 };
 
 
+struct request_stats
+{
+    timeout_t       total_time;
+    timeout_t       max_time;
+    unsigned int    count;
+    unsigned int    req;
+    char            name[32];
+};
+
+struct process_request_stats
+{
+    timeout_t       total_time;
+    process_id_t    pid;
+    unsigned int    count;
+};
+
+
+struct get_request_stats_request
+{
+    struct request_header __header;
+    int             reset;
+};
+struct get_request_stats_reply
+{
+    struct reply_header __header;
+    timeout_t       start_time;
+    int             req_count;
+    int             process_count;
+    /* VARARG(stats,request_stats); */
+};
+
+
 
 struct create_debug_obj_request
 {
@@ -3036,6 +3084,48 @@ struct set_named_pipe_info_reply
 };
 
 
+struct pipe_shm_ring
+{
+    int            lock;
+    int            seq;
+    unsigned int   head;
+    unsigned int   tail;
+    unsigned int   waiters;
+    unsigned int   nonblocking;
+    unsigned int   __pad[2];
+};
+
+struct pipe_shm
+{
+    unsigned int   state;
+    unsigned int   enabled;
+    unsigned int   conn_id;
+    unsigned int   __pad;
+    struct pipe_shm_ring ring[2];
+};
+
+#define PIPE_SHM_DATA_OFFSET 0x1000
+#define PIPE_SHM_RING_SIZE   0x10000
+#define PIPE_SHM_SIZE        (PIPE_SHM_DATA_OFFSET + 2 * PIPE_SHM_RING_SIZE)
+
+
+#define PIPE_SHM_LOCK_OWNER(pid)   ((pid) << 1)
+#define PIPE_SHM_LOCK_CONTENDED    1
+
+
+struct get_named_pipe_shm_info_request
+{
+    struct request_header __header;
+    obj_handle_t   handle;
+};
+struct get_named_pipe_shm_info_reply
+{
+    struct reply_header __header;
+    int            server_end;
+    unsigned int   conn_id;
+};
+
+
 struct create_window_request
 {
     struct request_header __header;
@@ -5424,6 +5514,24 @@ struct resume_process_reply
     struct reply_header __header;
 };
 
+
+
+struct get_next_thread_request
+{
+    struct request_header __header;
+    obj_handle_t process;
+    obj_handle_t last;
+    unsigned int access;
+    unsigned int attributes;
+    unsigned int flags;
+};
+struct get_next_thread_reply
+{
+    struct reply_header __header;
+    obj_handle_t handle;
+    char __pad_12[4];
+};
+
 enum esync_type
 {
     ESYNC_SEMAPHORE = 1,
@@ -5520,22 +5628,6 @@ struct get_esync_apc_fd_reply
     struct reply_header __header;
 };
 
-struct get_next_thread_request
-{
-    struct request_header __header;
-    obj_handle_t process;
-    obj_handle_t last;
-    unsigned int access;
-    unsigned int attributes;
-    unsigned int flags;
-};
-struct get_next_thread_reply
-{
-    struct reply_header __header;
-    obj_handle_t handle;
-    char __pad_12[4];
-};
-
 
 enum request
 {
@@ -5595,6 +5687,7 @@ enum request
     REQ_unlock_file,
     REQ_recv_socket,
     REQ_send_socket,
+    REQ_register_accepted_socket,
     REQ_get_next_console_request,
     REQ_read_directory_changes,
     REQ_read_change,
@@ -5608,6 +5701,7 @@ enum request
     REQ_is_same_mapping,
     REQ_get_mapping_filename,
     REQ_list_processes,
+    REQ_get_request_stats,
     REQ_create_debug_obj,
     REQ_wait_debug_event,
     REQ_queue_exception_event,
@@ -5669,6 +5763,7 @@ enum request
     REQ_set_irp_result,
     REQ_create_named_pipe,
     REQ_set_named_pipe_info,
+    REQ_get_named_pipe_shm_info,
     REQ_create_window,
     REQ_destroy_window,
     REQ_get_desktop_window,
@@ -5883,6 +5978,7 @@ union generic_request
     struct unlock_file_request unlock_file_request;
     struct recv_socket_request recv_socket_request;
     struct send_socket_request send_socket_request;
+    struct register_accepted_socket_request register_accepted_socket_request;
     struct get_next_console_request_request get_next_console_request_request;
     struct read_directory_changes_request read_directory_changes_request;
     struct read_change_request read_change_request;
@@ -5896,6 +5992,7 @@ union generic_request
     struct is_same_mapping_request is_same_mapping_request;
     struct get_mapping_filename_request get_mapping_filename_request;
     struct list_processes_request list_processes_request;
+    struct get_request_stats_request get_request_stats_request;
     struct create_debug_obj_request create_debug_obj_request;
     struct wait_debug_event_request wait_debug_event_request;
     struct queue_exception_event_request queue_exception_event_request;
@@ -5957,6 +6054,7 @@ union generic_request
     struct set_irp_result_request set_irp_result_request;
     struct create_named_pipe_request create_named_pipe_request;
     struct set_named_pipe_info_request set_named_pipe_info_request;
+    struct get_named_pipe_shm_info_request get_named_pipe_shm_info_request;
     struct create_window_request create_window_request;
     struct destroy_window_request destroy_window_request;
     struct get_desktop_window_request get_desktop_window_request;
@@ -6169,6 +6267,7 @@ union generic_reply
     struct unlock_file_reply unlock_file_reply;
     struct recv_socket_reply recv_socket_reply;
     struct send_socket_reply send_socket_reply;
+    struct register_accepted_socket_reply register_accepted_socket_reply;
     struct get_next_console_request_reply get_next_console_request_reply;
     struct read_directory_changes_reply read_directory_changes_reply;
     struct read_change_reply read_change_reply;
@@ -6182,6 +6281,7 @@ union generic_reply
     struct is_same_mapping_reply is_same_mapping_reply;
     struct get_mapping_filename_reply get_mapping_filename_reply;
     struct list_processes_reply list_processes_reply;
+    struct get_request_stats_reply get_request_stats_reply;
     struct create_debug_obj_reply create_debug_obj_reply;
     struct wait_debug_event_reply wait_debug_event_reply;
     struct queue_exception_event_reply queue_exception_event_reply;
@@ -6243,6 +6343,7 @@ union generic_reply
     struct set_irp_result_reply set_irp_result_reply;
     struct create_named_pipe_reply create_named_pipe_reply;
     struct set_named_pipe_info_reply set_named_pipe_info_reply;
+    struct get_named_pipe_shm_info_reply get_named_pipe_shm_info_reply;
     struct create_window_reply create_window_reply;
     struct destroy_window_reply destroy_window_reply;
     struct get_desktop_window_reply get_desktop_window_reply;
@@ -6398,7 +6499,7 @@ union generic_reply
 
 /* ### protocol_version begin ### */
 
-#define SERVER_PROTOCOL_VERSION 746
+#define SERVER_PROTOCOL_VERSION 751
 
 /* ### protocol_version end ### */
 
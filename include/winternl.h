@@ -3478,6 +3478,9 @@ typedef struct _RTL_PROCESS_MODULE_INFORMATION_EX
 #define THREAD_CREATE_FLAGS_ACCESS_CHECK_IN_TARGET  0x00000020
 #define THREAD_CREATE_FLAGS_INITIAL_THREAD          0x00000080
 
+/* TEB SameTebFlags */
+#define SAME_TEB_FLAGS_SKIP_THREAD_ATTACH           0x0008
+
 #define EH_NONCONTINUABLE   0x01
 #define EH_UNWINDING        0x02
 #define EH_EXIT_UNWIND      0x04
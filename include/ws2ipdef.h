@@ -331,6 +331,20 @@ typedef struct WS(in6_pktinfo) {
 #define WS_TCP_DELAY_FIN_ACK            13
 #endif /* USE_WS_PREFIX */
 
+#ifndef USE_WS_PREFIX
+#define UDP_NOCHECKSUM                  1
+#define UDP_SEND_MSG_SIZE               2
+#define UDP_RECV_MAX_COALESCED_SIZE     3
+#define UDP_COALESCED_INFO              UDP_RECV_MAX_COALESCED_SIZE
+#define UDP_CHECKSUM_COVERAGE           20
+#else
+#define WS_UDP_NOCHECKSUM               1
+#define WS_UDP_SEND_MSG_SIZE            2
+#define WS_UDP_RECV_MAX_COALESCED_SIZE  3
+#define WS_UDP_COALESCED_INFO           WS_UDP_RECV_MAX_COALESCED_SIZE
+#define WS_UDP_CHECKSUM_COVERAGE        20
+#endif /* USE_WS_PREFIX */
+
 #define PROTECTION_LEVEL_UNRESTRICTED   10
 #define PROTECTION_LEVEL_EDGERESTRICTED 20
 #define PROTECTION_LEVEL_RESTRICTED     30
@@ -0,0 +1,147 @@
+/*
+ * Dump the wineserver request statistics
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <ntstatus.h>
+#define WIN32_NO_STATUS
+#include <windef.h>
+#include <winbase.h>
+#include <winternl.h>
+
+#include "wine/server.h"
+#include "wine/debug.h"
+
+static const char progname[] = "wineserverstat";
+
+static void usage( int ret )
+{
+    printf( "Usage: %s [OPTION]\n", progname );
+    printf( "Display the number of wineserver requests of each type and the time spent handling them.\n"
+            "\n"
+            "  -r, --reset   reset the statistics after displaying them\n"
+            "  -h, --help    output this help message and exit\n" );
+    exit( ret );
+}
+
+static int compare_request_stats( const void *a, const void *b )
+{
+    const struct request_stats *stats_a = a, *stats_b = b;
+
+    if (stats_a->total_time != stats_b->total_time) return stats_a->total_time < stats_b->total_time ? 1 : -1;
+    return stats_a->req - stats_b->req;
+}
+
+static int compare_process_request_stats( const void *a, const void *b )
+{
+    const struct process_request_stats *stats_a = a, *stats_b = b;
+
+    if (stats_a->total_time != stats_b->total_time) return stats_a->total_time < stats_b->total_time ? 1 : -1;
+    return stats_a->pid - stats_b->pid;
+}
+
+int __cdecl wmain( int argc, WCHAR *argv[] )
+{
+    struct request_stats *stats;
+    struct process_request_stats *process_stats;
+    unsigned int size = 0x10000, req_count = 0, process_count = 0, count = 0, i;
+    timeout_t start_time = 0, total_time = 0;
+    LARGE_INTEGER now;
+    NTSTATUS status;
+    BOOLEAN enabled;
+    BOOL reset = FALSE;
+    void *buffer;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!wcscmp( argv[i], L"-r" ) || !wcscmp( argv[i], L"--reset" )) reset = TRUE;
+        else if (!wcscmp( argv[i], L"-h" ) || !wcscmp( argv[i], L"--help" )) usage( 0 );
+        else
+        {
+            fprintf( stderr, "%s: invalid option %s\n", progname, debugstr_w( argv[i] ));
+            usage( 2 );
+        }
+    }
+
+    /* the server only returns the statistics of all processes to debuggers */
+    if ((status = RtlAdjustPrivilege( SE_DEBUG_PRIVILEGE, TRUE, FALSE, &enabled )))
+    {
+        fprintf( stderr, "%s: cannot enable the debug privilege, status %#x\n", progname, (int)status );
+        return 1;
+    }
+
+    for (;;)
+    {
+        if (!(buffer = malloc( size ))) return 1;
+
+        SERVER_START_REQ( get_request_stats )
+        {
+            req->reset = reset;
+            wine_server_set_reply( req, buffer, size );
+            if (!(status = wine_server_call( req )))
+            {
+                start_time    = reply->start_time;
+                req_count     = reply->req_count;
+                process_count = reply->process_count;
+            }
+        }
+        SERVER_END_REQ;
+
+        if (status != STATUS_BUFFER_TOO_SMALL) break;
+        free( buffer );
+        size *= 2;
+    }
+
+    if (status)
+    {
+        fprintf( stderr, "%s: cannot retrieve the server statistics, status %#x\n", progname, (int)status );
+        free( buffer );
+        return 1;
+    }
+
+    stats = buffer;
+    process_stats = (struct process_request_stats *)(stats + req_count);
+    qsort( stats, req_count, sizeof(*stats), compare_request_stats );
+    qsort( process_stats, process_count, sizeof(*process_stats), compare_process_request_stats );
+
+    for (i = 0; i < req_count; i++)
+    {
+        count += stats[i].count;
+        total_time += stats[i].total_time;
+    }
+
+    NtQuerySystemTime( &now );
+    printf( "%u requests in %.3f s, %.3f ms spent in request handlers\n\n", count,
+            (now.QuadPart - start_time) / 10000000.0, total_time / 10000.0 );
+
+    printf( "%-32s %10s %12s %10s %10s %6s\n", "request", "count", "total (ms)", "avg (us)", "max (us)", "%" );
+    for (i = 0; i < req_count; i++)
+        printf( "%-32.32s %10u %12.3f %10.3f %10.3f %6.2f\n", stats[i].name, stats[i].count,
+                stats[i].total_time / 10000.0, stats[i].total_time / 10.0 / stats[i].count,
+                stats[i].max_time / 10.0, total_time ? stats[i].total_time * 100.0 / total_time : 0.0 );
+
+    printf( "\n%-8s %10s %12s\n", "pid", "count", "total (ms)" );
+    for (i = 0; i < process_count; i++)
+        printf( "%04x     %10u %12.3f\n", process_stats[i].pid, process_stats[i].count,
+                process_stats[i].total_time / 10000.0 );
+
+    free( buffer );
+    return 0;
+}
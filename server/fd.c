@@ -2139,6 +2139,14 @@ void allow_fd_caching( struct fd *fd )
     fd->cacheable = 1;
 }
 
+/* attach a unix fd to a pseudo fd so that it can be passed to the client; the fd takes ownership of it */
+void set_pseudo_fd_unix_fd( struct fd *fd, int unix_fd )
+{
+    assert( !fd->inode && fd->poll_index == -1 );
+    if (fd->unix_fd != -1) close( fd->unix_fd );
+    fd->unix_fd = unix_fd;
+}
+
 /* check if fd is on a removable device */
 int is_fd_removable( struct fd *fd )
 {
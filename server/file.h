@@ -101,6 +101,7 @@ extern void set_fd_events( struct fd *fd, int events );
 extern obj_handle_t lock_fd( struct fd *fd, file_pos_t offset, file_pos_t count, int shared, int wait );
 extern void unlock_fd( struct fd *fd, file_pos_t offset, file_pos_t count );
 extern void allow_fd_caching( struct fd *fd );
+extern void set_pseudo_fd_unix_fd( struct fd *fd, int unix_fd );
 extern void set_fd_signaled( struct fd *fd, int signaled );
 extern char *dup_fd_name( struct fd *root, const char *name );
 extern void get_nt_name( struct fd *fd, struct unicode_str *name );
@@ -174,6 +175,7 @@ extern int is_file_executable( const char *name );
 struct memory_view;
 
 extern int grow_file( int unix_fd, file_pos_t new_size );
+extern int create_temp_file( file_pos_t size );
 extern struct memory_view *find_mapped_view( struct process *process, client_ptr_t base );
 extern struct memory_view *get_exe_view( struct process *process );
 extern struct file *get_view_file( const struct memory_view *view, unsigned int access, unsigned int sharing );
@@ -198,6 +200,7 @@ extern struct object *create_socket_device( struct object *root, const struct un
                                               unsigned int attr, const struct security_descriptor *sd );
 extern struct object *create_unix_device( struct object *root, const struct unicode_str *name,
                                           unsigned int attr, const struct security_descriptor *sd, const char *unix_path );
+extern void release_pipe_shm_locks( struct process *process );
 
 /* change notification functions */
 
@@ -121,6 +121,25 @@ static const struct object_ops shared_map_ops =
 
 static struct list shared_map_list = LIST_INIT( shared_map_list );
 
+/* cached parameters of a PE image file, to avoid parsing the headers again on every mapping */
+struct image_cache_entry
+{
+    struct list     entry;           /* entry in image cache list */
+    dev_t           dev;             /* identity and change times of the image file */
+    ino_t           ino;
+    file_pos_t      size;
+    struct timespec mtime;
+    struct timespec ctime;
+    unsigned int    cpu_mask;        /* supported cpus when the image was parsed */
+    int             has_shared;      /* whether the image has shared writable sections */
+    pe_image_info_t image;           /* image info */
+};
+
+#define MAX_IMAGE_CACHE_ENTRIES 256
+
+static struct list image_cache = LIST_INIT( image_cache );
+static unsigned int image_cache_count;
+
 /* memory view mapped in client address space */
 struct memory_view
 {
@@ -297,7 +316,7 @@ static int check_current_dir_for_exec(void)
 }
 
 /* create a temp file for anonymous mappings */
-static int create_temp_file( file_pos_t size )
+int create_temp_file( file_pos_t size )
 {
     static int temp_dir_fd = -1;
     char tmpfn[16];
@@ -659,8 +678,8 @@ static int load_clr_header( IMAGE_COR20_HEADER *hdr, size_t va, size_t size, int
     return 0;
 }
 
-/* retrieve the mapping parameters for an executable (PE) image */
-static unsigned int get_image_params( struct mapping *mapping, file_pos_t file_size, int unix_fd )
+/* load the mapping parameters for an executable (PE) image from the file headers */
+static unsigned int load_image_params( struct mapping *mapping, file_pos_t file_size, int unix_fd )
 {
     static const char builtin_signature[] = "Wine builtin DLL";
     static const char fakedll_signature[] = "Wine placeholder DLL";
@@ -882,6 +901,97 @@ static unsigned int get_image_params( struct mapping *mapping, file_pos_t file_s
     return STATUS_SUCCESS;
 }
 
+static void get_stat_times( const struct stat *st, struct timespec *mtime, struct timespec *ctime )
+{
+    mtime->tv_sec = st->st_mtime;
+    ctime->tv_sec = st->st_ctime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+    mtime->tv_nsec = st->st_mtim.tv_nsec;
+    ctime->tv_nsec = st->st_ctim.tv_nsec;
+#elif defined(HAVE_STRUCT_STAT_ST_MTIMESPEC)
+    mtime->tv_nsec = st->st_mtimespec.tv_nsec;
+    ctime->tv_nsec = st->st_ctimespec.tv_nsec;
+#else
+    mtime->tv_nsec = ctime->tv_nsec = 0;
+#endif
+}
+
+/* find the cached image parameters for a file, if it hasn't changed since they were cached */
+static struct image_cache_entry *find_image_cache_entry( const struct stat *st, unsigned int cpu_mask )
+{
+    struct image_cache_entry *cache;
+    struct timespec mtime, ctime;
+
+    get_stat_times( st, &mtime, &ctime );
+
+    LIST_FOR_EACH_ENTRY( cache, &image_cache, struct image_cache_entry, entry )
+    {
+        if (cache->dev != st->st_dev || cache->ino != st->st_ino) continue;
+        if (cache->size == st->st_size && cache->cpu_mask == cpu_mask &&
+            cache->mtime.tv_sec == mtime.tv_sec && cache->mtime.tv_nsec == mtime.tv_nsec &&
+            cache->ctime.tv_sec == ctime.tv_sec && cache->ctime.tv_nsec == ctime.tv_nsec)
+        {
+            /* move it to the head of the list */
+            list_remove( &cache->entry );
+            list_add_head( &image_cache, &cache->entry );
+            return cache;
+        }
+        /* the file has been modified */
+        list_remove( &cache->entry );
+        image_cache_count--;
+        free( cache );
+        break;
+    }
+    return NULL;
+}
+
+/* add the parameters of a successfully parsed image to the cache */
+static void add_image_cache_entry( const struct stat *st, unsigned int cpu_mask, const struct mapping *mapping )
+{
+    struct image_cache_entry *cache;
+
+    if (image_cache_count >= MAX_IMAGE_CACHE_ENTRIES)
+    {
+        cache = LIST_ENTRY( list_tail( &image_cache ), struct image_cache_entry, entry );
+        list_remove( &cache->entry );
+        image_cache_count--;
+    }
+    else if (!(cache = malloc( sizeof(*cache) ))) return;
+
+    cache->dev        = st->st_dev;
+    cache->ino        = st->st_ino;
+    cache->size       = st->st_size;
+    cache->cpu_mask   = cpu_mask;
+    cache->has_shared = mapping->shared != NULL;
+    cache->image      = mapping->image;
+    get_stat_times( st, &cache->mtime, &cache->ctime );
+    list_add_head( &image_cache, &cache->entry );
+    image_cache_count++;
+}
+
+/* retrieve the mapping parameters for an executable (PE) image */
+static unsigned int get_image_params( struct mapping *mapping, const struct stat *st, int unix_fd )
+{
+    unsigned int status, cpu_mask = get_supported_cpu_mask();
+    struct image_cache_entry *cache;
+
+    if ((cache = find_image_cache_entry( st, cpu_mask )))
+    {
+        if (mapping->size > cache->image.map_size) return STATUS_SECTION_TOO_BIG;
+        /* the shared sections need to be loaded again if no other mapping is using them */
+        if (!cache->has_shared || (mapping->shared = get_shared_file( mapping->fd )))
+        {
+            mapping->image = cache->image;
+            if (!mapping->size) mapping->size = mapping->image.map_size;
+            return STATUS_SUCCESS;
+        }
+    }
+
+    if ((status = load_image_params( mapping, st->st_size, unix_fd ))) return status;
+    if (!cache) add_image_cache_entry( st, cpu_mask, mapping );
+    return STATUS_SUCCESS;
+}
+
 static struct ranges *create_ranges(void)
 {
     struct ranges *ranges = alloc_object( &ranges_ops );
@@ -973,7 +1083,7 @@ static struct mapping *create_mapping( struct object *root, const struct unicode
         }
         if (flags & SEC_IMAGE)
         {
-            unsigned int err = get_image_params( mapping, st.st_size, unix_fd );
+            unsigned int err = get_image_params( mapping, &st, unix_fd );
             if (!err) return mapping;
             set_error( err );
             goto error;
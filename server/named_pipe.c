@@ -23,11 +23,17 @@
 #include "config.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/mman.h>
+#ifdef HAVE_SYS_SYSCALL_H
+#include <sys/syscall.h>
+#endif
+#include <unistd.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -63,6 +69,9 @@ struct pipe_end
     process_id_t         client_pid; /* process that created the client */
     process_id_t         server_pid; /* process that created the server */
     data_size_t          buffer_size;/* size of buffered data that doesn't block caller */
+    struct pipe_shm     *shm;        /* shared memory rings used for local I/O */
+    unsigned int         shm_conn_id;/* connection id the shared memory rings belong to */
+    struct list          shm_entry;  /* entry in the list of pipe ends with shared memory rings */
     struct list          message_queue;
     struct async_queue   read_q;     /* read queue */
     struct async_queue   write_q;    /* write queue */
@@ -404,16 +413,193 @@ static void free_message( struct pipe_message *message )
     free( message );
 }
 
+#ifdef __linux__
+static int do_shm_pipes(void)
+{
+    static int do_shm_pipes_cached = -1;
+
+    if (do_shm_pipes_cached == -1)
+        do_shm_pipes_cached = getenv("WINESHMPIPE") && atoi(getenv("WINESHMPIPE"));
+
+    return do_shm_pipes_cached;
+}
+
+static void pipe_shm_wake( int *addr )
+{
+    syscall( __NR_futex, addr, 1 /* FUTEX_WAKE */, INT_MAX, NULL, 0, 0 );
+}
+#else
+static int do_shm_pipes(void) { return 0; }
+static void pipe_shm_wake( int *addr ) { }
+#endif
+
+static struct list shm_pipe_ends = LIST_INIT( shm_pipe_ends );
+
+static inline unsigned int pipe_end_shm_index( struct pipe_end *pipe_end )
+{
+    return pipe_end->obj.ops == &pipe_server_ops ? 0 : 1;
+}
+
+/* get the shared memory rings if they are used for the current connection of the pipe end */
+static struct pipe_shm *get_pipe_end_shm( struct pipe_end *pipe_end )
+{
+    struct pipe_shm *shm = pipe_end->shm;
+
+    if (!shm || !shm->enabled || shm->conn_id != pipe_end->shm_conn_id) return NULL;
+    return shm;
+}
+
+/* the rings are updated by the clients without any locking on our side, so the results are only a snapshot */
+static data_size_t pipe_shm_avail( struct pipe_shm *shm, unsigned int index )
+{
+    unsigned int tail = __atomic_load_n( &shm->ring[index].tail, __ATOMIC_ACQUIRE );
+    unsigned int head = __atomic_load_n( &shm->ring[index].head, __ATOMIC_ACQUIRE );
+
+    return min( head - tail, PIPE_SHM_RING_SIZE );
+}
+
+static void pipe_shm_peek( struct pipe_shm *shm, unsigned int index, char *buffer, data_size_t size )
+{
+    const char *data = (const char *)shm + PIPE_SHM_DATA_OFFSET + index * PIPE_SHM_RING_SIZE;
+    unsigned int pos = shm->ring[index].tail % PIPE_SHM_RING_SIZE;
+    data_size_t len = min( size, PIPE_SHM_RING_SIZE - pos );
+
+    memcpy( buffer, data + pos, len );
+    memcpy( buffer + len, data, size - len );
+}
+
+static struct pipe_shm *map_pipe_shm( int unix_fd )
+{
+    struct pipe_shm *shm = mmap( NULL, PIPE_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, unix_fd, 0 );
+    return shm == MAP_FAILED ? NULL : shm;
+}
+
+/* set the connection state and wake up all the threads waiting on the rings; the clients
+ * read the sequence before checking the state, so bumping it after the update can't be missed */
+static void pipe_shm_set_state( struct pipe_shm *shm, unsigned int state )
+{
+    unsigned int i;
+
+    __atomic_store_n( &shm->state, state, __ATOMIC_RELEASE );
+    for (i = 0; i < ARRAY_SIZE(shm->ring); i++)
+    {
+        __atomic_fetch_add( &shm->ring[i].seq, 1, __ATOMIC_SEQ_CST );
+        pipe_shm_wake( &shm->ring[i].seq );
+    }
+}
+
+/* release the ring locks still held by a process that died in the middle of a transfer */
+static void pipe_shm_break_locks( struct pipe_shm *shm, process_id_t pid )
+{
+    unsigned int i;
+    int lock;
+
+    for (i = 0; i < ARRAY_SIZE(shm->ring); i++)
+    {
+        lock = __atomic_load_n( &shm->ring[i].lock, __ATOMIC_ACQUIRE );
+        while ((lock & ~PIPE_SHM_LOCK_CONTENDED) == PIPE_SHM_LOCK_OWNER( pid ))
+        {
+            if (!__atomic_compare_exchange_n( &shm->ring[i].lock, &lock, 0, 0,
+                                              __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ))
+                continue;
+            pipe_shm_wake( &shm->ring[i].lock );
+            break;
+        }
+    }
+}
+
+/* called when a process is gone; other processes may still use the rings through their own mappings */
+void release_pipe_shm_locks( struct process *process )
+{
+    struct pipe_end *pipe_end;
+
+    LIST_FOR_EACH_ENTRY( pipe_end, &shm_pipe_ends, struct pipe_end, shm_entry )
+        pipe_shm_break_locks( pipe_end->shm, process->id );
+}
+
+/* create the shared memory rings of a synchronous byte mode server end */
+static void create_pipe_shm( struct pipe_server *server )
+{
+    struct pipe_shm *shm;
+    int unix_fd;
+
+    if (!do_shm_pipes() || server->pipe_end.pipe->message_mode ||
+        !(server->options & (FILE_SYNCHRONOUS_IO_ALERT | FILE_SYNCHRONOUS_IO_NONALERT)))
+        return;
+
+    if ((unix_fd = create_temp_file( PIPE_SHM_SIZE )) == -1)
+    {
+        clear_error();
+        return;
+    }
+    if (!(shm = map_pipe_shm( unix_fd )))
+    {
+        close( unix_fd );
+        return;
+    }
+    shm->state = FILE_PIPE_LISTENING_STATE;
+    shm->conn_id = 1;
+    set_pseudo_fd_unix_fd( server->pipe_end.fd, unix_fd );
+    server->pipe_end.shm = shm;
+    list_add_tail( &shm_pipe_ends, &server->pipe_end.shm_entry );
+}
+
+/* start using the shared memory rings for a new connection if both ends are synchronous */
+static void pipe_shm_connect( struct pipe_end *server, struct pipe_end *client, unsigned int options )
+{
+    struct pipe_shm *shm = server->shm;
+    int unix_fd;
+
+    if (!shm) return;
+    shm->enabled = 0;
+    server->shm_conn_id = shm->conn_id;
+
+    /* a thread from a previous connection may still be holding one of the locks */
+    if ((options & (FILE_SYNCHRONOUS_IO_ALERT | FILE_SYNCHRONOUS_IO_NONALERT)) &&
+        !shm->ring[0].lock && !shm->ring[1].lock &&
+        (unix_fd = dup( get_unix_fd( server->fd ))) != -1)
+    {
+        if ((client->shm = map_pipe_shm( unix_fd )))
+        {
+            shm->ring[0].head = shm->ring[0].tail = 0;
+            shm->ring[1].head = shm->ring[1].tail = 0;
+            shm->ring[0].nonblocking = (server->flags & NAMED_PIPE_NONBLOCKING_MODE) != 0;
+            shm->ring[1].nonblocking = (client->flags & NAMED_PIPE_NONBLOCKING_MODE) != 0;
+            __atomic_store_n( &shm->enabled, 1, __ATOMIC_SEQ_CST );
+            set_pseudo_fd_unix_fd( client->fd, unix_fd );
+            client->shm_conn_id = shm->conn_id;
+            list_add_tail( &shm_pipe_ends, &client->shm_entry );
+        }
+        else close( unix_fd );
+    }
+    pipe_shm_set_state( shm, FILE_PIPE_CONNECTED_STATE );
+}
+
+/* stop using the shared memory rings when the server end starts listening again */
+static void pipe_shm_listen( struct pipe_end *server )
+{
+    struct pipe_shm *shm = server->shm;
+
+    if (!shm) return;
+    shm->enabled = 0;
+    shm->conn_id++;
+    pipe_shm_set_state( shm, FILE_PIPE_LISTENING_STATE );
+}
+
 static void pipe_end_disconnect( struct pipe_end *pipe_end, unsigned int status )
 {
     struct pipe_end *connection = pipe_end->connection;
     struct pipe_message *message, *next;
+    struct pipe_shm *shm;
     struct async *async;
 
     pipe_end->connection = NULL;
 
     pipe_end->state = status == STATUS_PIPE_DISCONNECTED
         ? FILE_PIPE_DISCONNECTED_STATE : FILE_PIPE_CLOSING_STATE;
+    /* once the connection is gone, the rings may already be used by a new one */
+    if ((connection || !pipe_end_shm_index( pipe_end )) && (shm = get_pipe_end_shm( pipe_end )))
+        pipe_shm_set_state( shm, pipe_end->state );
     fd_async_wake_up( pipe_end->fd, ASYNC_TYPE_WAIT, status );
     async_wake_up( &pipe_end->read_q, status );
     LIST_FOR_EACH_ENTRY_SAFE( message, next, &pipe_end->message_queue, struct pipe_message, entry )
@@ -449,6 +635,11 @@ static void pipe_end_destroy( struct object *obj )
 
     free_async_queue( &pipe_end->read_q );
     free_async_queue( &pipe_end->write_q );
+    if (pipe_end->shm)
+    {
+        list_remove( &pipe_end->shm_entry );
+        munmap( pipe_end->shm, PIPE_SHM_SIZE );
+    }
     if (pipe_end->fd) release_object( pipe_end->fd );
     if (pipe_end->pipe) release_object( pipe_end->pipe );
 }
@@ -671,6 +862,7 @@ static void pipe_end_get_file_info( struct fd *fd, obj_handle_t handle, unsigned
         {
             FILE_PIPE_LOCAL_INFORMATION *pipe_info;
             struct pipe_message *message;
+            struct pipe_shm *shm;
             data_size_t avail = 0;
 
             if (!(get_handle_access( current->process, handle) & FILE_READ_ATTRIBUTES))
@@ -709,7 +901,9 @@ static void pipe_end_get_file_info( struct fd *fd, obj_handle_t handle, unsigned
             pipe_info->CurrentInstances    = pipe->instances;
             pipe_info->InboundQuota        = pipe->insize;
 
-            LIST_FOR_EACH_ENTRY( message, &pipe_end->message_queue, struct pipe_message, entry )
+            if ((shm = get_pipe_end_shm( pipe_end )))
+                avail = pipe_shm_avail( shm, pipe_end_shm_index( pipe_end ));
+            else LIST_FOR_EACH_ENTRY( message, &pipe_end->message_queue, struct pipe_message, entry )
                 avail += message->iosb->in_size - message->read_pos;
             pipe_info->ReadDataAvailable   = avail;
 
@@ -987,6 +1181,8 @@ static void pipe_end_peek( struct pipe_end *pipe_end )
     unsigned reply_size = get_reply_max_size();
     FILE_PIPE_PEEK_BUFFER *buffer;
     struct pipe_message *message;
+    struct pipe_shm *shm = get_pipe_end_shm( pipe_end );
+    unsigned int index = pipe_end_shm_index( pipe_end );
     data_size_t avail = 0;
     data_size_t message_length = 0;
 
@@ -1003,6 +1199,7 @@ static void pipe_end_peek( struct pipe_end *pipe_end )
         break;
     case FILE_PIPE_CLOSING_STATE:
         if (!list_empty( &pipe_end->message_queue )) break;
+        if (shm && pipe_shm_avail( shm, index )) break;
         set_error( STATUS_PIPE_BROKEN );
         return;
     default:
@@ -1010,7 +1207,8 @@ static void pipe_end_peek( struct pipe_end *pipe_end )
         return;
     }
 
-    LIST_FOR_EACH_ENTRY( message, &pipe_end->message_queue, struct pipe_message, entry )
+    if (shm) avail = pipe_shm_avail( shm, index );
+    else LIST_FOR_EACH_ENTRY( message, &pipe_end->message_queue, struct pipe_message, entry )
         avail += message->iosb->in_size - message->read_pos;
     reply_size = min( reply_size, avail );
 
@@ -1027,7 +1225,8 @@ static void pipe_end_peek( struct pipe_end *pipe_end )
     buffer->NumberOfMessages  = 0;  /* FIXME */
     buffer->MessageLength     = message_length;
 
-    if (reply_size)
+    if (reply_size && shm) pipe_shm_peek( shm, index, (char *)buffer->Data, reply_size );
+    else if (reply_size)
     {
         data_size_t write_pos = 0, writing;
         LIST_FOR_EACH_ENTRY( message, &pipe_end->message_queue, struct pipe_message, entry )
@@ -1146,6 +1345,7 @@ static void pipe_server_ioctl( struct fd *fd, ioctl_code_t code, struct async *a
         case FILE_PIPE_DISCONNECTED_STATE:
             server->pipe_end.state = FILE_PIPE_LISTENING_STATE;
             list_add_tail( &server->pipe_end.pipe->listeners, &server->entry );
+            pipe_shm_listen( &server->pipe_end );
             break;
         case FILE_PIPE_CONNECTED_STATE:
             set_error( STATUS_PIPE_CONNECTED );
@@ -1226,6 +1426,8 @@ static void init_pipe_end( struct pipe_end *pipe_end, struct named_pipe *pipe,
     pipe_end->flags = pipe_flags;
     pipe_end->connection = NULL;
     pipe_end->buffer_size = buffer_size;
+    pipe_end->shm = NULL;
+    pipe_end->shm_conn_id = 0;
     init_async_queue( &pipe_end->read_q );
     init_async_queue( &pipe_end->write_q );
     list_init( &pipe_end->message_queue );
@@ -1253,6 +1455,7 @@ static struct pipe_server *create_pipe_server( struct named_pipe *pipe, unsigned
         return NULL;
     }
     allow_fd_caching( server->pipe_end.fd );
+    create_pipe_shm( server );
     set_fd_signaled( server->pipe_end.fd, 1 );
     async_wake_up( &pipe->waiters, STATUS_SUCCESS );
     return server;
@@ -1328,6 +1531,7 @@ static struct object *named_pipe_open_file( struct object *obj, unsigned int acc
         server->pipe_end.client_pid = client->client_pid;
         client->server_pid = server->pipe_end.server_pid;
         list_remove( &server->entry );
+        pipe_shm_connect( &server->pipe_end, client, options );
     }
     return &client->obj;
 }
@@ -1481,8 +1685,33 @@ DECL_HANDLER(set_named_pipe_info)
     }
     else
     {
+        struct pipe_shm *shm;
+
         pipe_end->flags = req->flags;
+        if ((shm = get_pipe_end_shm( pipe_end )))
+            shm->ring[pipe_end_shm_index( pipe_end )].nonblocking = (req->flags & NAMED_PIPE_NONBLOCKING_MODE) != 0;
+    }
+
+    release_object( pipe_end );
+}
+
+DECL_HANDLER(get_named_pipe_shm_info)
+{
+    struct pipe_end *pipe_end;
+
+    pipe_end = (struct pipe_end *)get_handle_obj( current->process, req->handle, 0, &pipe_server_ops );
+    if (!pipe_end)
+    {
+        if (get_error() != STATUS_OBJECT_TYPE_MISMATCH)
+            return;
+
+        clear_error();
+        pipe_end = (struct pipe_end *)get_handle_obj( current->process, req->handle,
+                                                      0, &pipe_client_ops );
+        if (!pipe_end) return;
     }
 
+    reply->server_end = !pipe_end_shm_index( pipe_end );
+    reply->conn_id    = pipe_end->shm_conn_id;
     release_object( pipe_end );
 }
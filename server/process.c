@@ -686,6 +686,8 @@ struct process *create_process( int fd, struct process *parent, unsigned int fla
     process->rawinput_mouse  = NULL;
     process->rawinput_kbd    = NULL;
     process->esync_fd        = NULL;
+    process->request_count   = 0;
+    process->request_time    = 0;
     memset( &process->image_info, 0, sizeof(process->image_info) );
     list_init( &process->kernel_object );
     list_init( &process->thread_list );
@@ -999,6 +1001,7 @@ static void process_killed( struct process *process )
     free_mapped_views( process );
     free_process_user_handles( process );
     remove_process_locks( process );
+    release_pipe_shm_locks( process );
     set_process_startup_state( process, STARTUP_ABORTED );
     finish_process_tracing( process );
     release_job_process( process );
@@ -90,6 +90,8 @@ struct process
     const struct rawinput_device *rawinput_kbd;   /* rawinput keyboard device, if any */
     struct list          kernel_object;   /* list of kernel object pointers */
     struct esync_fd     *esync_fd;        /* esync file descriptor (signaled on exit) */
+    unsigned int         request_count;   /* number of server requests made */
+    timeout_t            request_time;    /* time spent handling the server requests */
 };
 
 #define CPU_FLAG(cpu) (1 << (cpu))
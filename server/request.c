@@ -121,6 +121,15 @@ static const struct fd_ops master_socket_fd_ops =
 struct thread *current = NULL;  /* thread handling the current request */
 unsigned int global_error = 0;  /* global error code for when no thread is current */
 timeout_t server_start_time = 0;  /* server startup time */
+
+/* per request type statistics */
+static struct
+{
+    unsigned int count;       /* number of calls */
+    timeout_t    total_time;  /* cumulative time spent in the handler */
+    timeout_t    max_time;    /* longest time spent in a single call */
+} req_stats[REQ_NB_REQUESTS];
+static timeout_t req_stats_start_time;  /* time the statistics were last reset */
 char *server_dir = NULL;   /* server directory */
 int server_dir_fd = -1;    /* file descriptor for the server dir */
 int config_dir_fd = -1;    /* file descriptor for the config dir */
@@ -293,6 +302,7 @@ static void call_req_handler( struct thread *thread )
 {
     union generic_reply reply;
     enum request req = thread->req.request_header.req;
+    timeout_t start, time;
 
     current = thread;
     current->reply_size = 0;
@@ -302,7 +312,21 @@ static void call_req_handler( struct thread *thread )
     if (debug_level) trace_request();
 
     if (req < REQ_NB_REQUESTS)
+    {
+        start = monotonic_counter();
         req_handlers[req]( &current->req, &reply );
+        time = monotonic_counter() - start;
+
+        req_stats[req].count++;
+        req_stats[req].total_time += time;
+        if (time > req_stats[req].max_time) req_stats[req].max_time = time;
+        /* a thread killed by its own request may be gone, but otherwise it holds a reference to its process */
+        if (current)
+        {
+            current->process->request_count++;
+            current->process->request_time += time;
+        }
+    }
     else
         set_error( STATUS_NOT_IMPLEMENTED );
 
@@ -958,3 +982,82 @@ void close_master_socket( timeout_t timeout )
 
     master_timeout = add_timeout_user( timeout, close_socket_timeout, NULL );
 }
+
+static int count_process_request_stats( struct process *process, void *arg )
+{
+    unsigned int *count = arg;
+    if (process->request_count) (*count)++;
+    return 0;
+}
+
+static int get_process_request_stats( struct process *process, void *arg )
+{
+    struct process_request_stats **stats = arg;
+
+    if (!process->request_count) return 0;
+    (*stats)->total_time = process->request_time;
+    (*stats)->pid        = process->id;
+    (*stats)->count      = process->request_count;
+    (*stats)++;
+    return 0;
+}
+
+static int reset_process_request_stats( struct process *process, void *arg )
+{
+    process->request_count = 0;
+    process->request_time = 0;
+    return 0;
+}
+
+/* retrieve the server request statistics; they cover all processes, so this requires the debug privilege */
+DECL_HANDLER(get_request_stats)
+{
+    struct request_stats *stats;
+    struct process_request_stats *process_stats;
+    const char *name;
+    unsigned int i, req_count = 0, process_count = 0;
+    data_size_t size;
+
+    if (!thread_single_check_privilege( current, SeDebugPrivilege ))
+    {
+        set_error( STATUS_PRIVILEGE_NOT_HELD );
+        return;
+    }
+
+    for (i = 0; i < REQ_NB_REQUESTS; i++) if (req_stats[i].count) req_count++;
+    enum_processes( count_process_request_stats, &process_count );
+
+    size = req_count * sizeof(*stats) + process_count * sizeof(*process_stats);
+    if (size > get_reply_max_size())
+    {
+        set_error( STATUS_BUFFER_TOO_SMALL );
+        return;
+    }
+    if (!(stats = set_reply_data_size( size ))) return;
+
+    reply->start_time    = req_stats_start_time ? req_stats_start_time : server_start_time;
+    reply->req_count     = req_count;
+    reply->process_count = process_count;
+
+    memset( stats, 0, size );
+    for (i = 0; i < REQ_NB_REQUESTS; i++)
+    {
+        if (!req_stats[i].count) continue;
+        stats->total_time = req_stats[i].total_time;
+        stats->max_time   = req_stats[i].max_time;
+        stats->count      = req_stats[i].count;
+        stats->req        = i;
+        name = get_request_name( i );
+        memcpy( stats->name, name, min( strlen( name ), sizeof(stats->name) - 1 ));
+        stats++;
+    }
+    process_stats = (struct process_request_stats *)stats;
+    enum_processes( get_process_request_stats, &process_stats );
+
+    if (req->reset)
+    {
+        memset( req_stats, 0, sizeof(req_stats) );
+        enum_processes( reset_process_request_stats, NULL );
+        req_stats_start_time = current_time;
+    }
+}
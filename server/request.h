@@ -65,6 +65,7 @@ extern int server_dir_fd, config_dir_fd;
 
 extern void trace_request(void);
 extern void trace_reply( enum request req, const union generic_reply *reply );
+extern const char *get_request_name( enum request req );
 
 /* get current tick count to return to client */
 static inline unsigned int get_tick_count(void)
@@ -175,6 +176,7 @@ DECL_HANDLER(lock_file);
 DECL_HANDLER(unlock_file);
 DECL_HANDLER(recv_socket);
 DECL_HANDLER(send_socket);
+DECL_HANDLER(register_accepted_socket);
 DECL_HANDLER(get_next_console_request);
 DECL_HANDLER(read_directory_changes);
 DECL_HANDLER(read_change);
@@ -188,6 +190,7 @@ DECL_HANDLER(add_mapping_committed_range);
 DECL_HANDLER(is_same_mapping);
 DECL_HANDLER(get_mapping_filename);
 DECL_HANDLER(list_processes);
+DECL_HANDLER(get_request_stats);
 DECL_HANDLER(create_debug_obj);
 DECL_HANDLER(wait_debug_event);
 DECL_HANDLER(queue_exception_event);
@@ -249,6 +252,7 @@ DECL_HANDLER(ioctl);
 DECL_HANDLER(set_irp_result);
 DECL_HANDLER(create_named_pipe);
 DECL_HANDLER(set_named_pipe_info);
+DECL_HANDLER(get_named_pipe_shm_info);
 DECL_HANDLER(create_window);
 DECL_HANDLER(destroy_window);
 DECL_HANDLER(get_desktop_window);
@@ -462,6 +466,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_unlock_file,
     (req_handler)req_recv_socket,
     (req_handler)req_send_socket,
+    (req_handler)req_register_accepted_socket,
     (req_handler)req_get_next_console_request,
     (req_handler)req_read_directory_changes,
     (req_handler)req_read_change,
@@ -475,6 +480,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_is_same_mapping,
     (req_handler)req_get_mapping_filename,
     (req_handler)req_list_processes,
+    (req_handler)req_get_request_stats,
     (req_handler)req_create_debug_obj,
     (req_handler)req_wait_debug_event,
     (req_handler)req_queue_exception_event,
@@ -536,6 +542,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_set_irp_result,
     (req_handler)req_create_named_pipe,
     (req_handler)req_set_named_pipe_info,
+    (req_handler)req_get_named_pipe_shm_info,
     (req_handler)req_create_window,
     (req_handler)req_destroy_window,
     (req_handler)req_get_desktop_window,
@@ -1069,6 +1076,11 @@ C_ASSERT( sizeof(struct send_socket_request) == 64 );
 C_ASSERT( FIELD_OFFSET(struct send_socket_reply, wait) == 8 );
 C_ASSERT( FIELD_OFFSET(struct send_socket_reply, options) == 12 );
 C_ASSERT( sizeof(struct send_socket_reply) == 16 );
+C_ASSERT( FIELD_OFFSET(struct register_accepted_socket_request, listen) == 12 );
+C_ASSERT( FIELD_OFFSET(struct register_accepted_socket_request, fd) == 16 );
+C_ASSERT( sizeof(struct register_accepted_socket_request) == 24 );
+C_ASSERT( FIELD_OFFSET(struct register_accepted_socket_reply, handle) == 8 );
+C_ASSERT( sizeof(struct register_accepted_socket_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_next_console_request_request, handle) == 12 );
 C_ASSERT( FIELD_OFFSET(struct get_next_console_request_request, signal) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_next_console_request_request, read) == 20 );
@@ -1140,6 +1152,12 @@ C_ASSERT( FIELD_OFFSET(struct list_processes_reply, process_count) == 12 );
 C_ASSERT( FIELD_OFFSET(struct list_processes_reply, total_thread_count) == 16 );
 C_ASSERT( FIELD_OFFSET(struct list_processes_reply, total_name_len) == 20 );
 C_ASSERT( sizeof(struct list_processes_reply) == 24 );
+C_ASSERT( FIELD_OFFSET(struct get_request_stats_request, reset) == 12 );
+C_ASSERT( sizeof(struct get_request_stats_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_request_stats_reply, start_time) == 8 );
+C_ASSERT( FIELD_OFFSET(struct get_request_stats_reply, req_count) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_request_stats_reply, process_count) == 20 );
+C_ASSERT( sizeof(struct get_request_stats_reply) == 24 );
 C_ASSERT( FIELD_OFFSET(struct create_debug_obj_request, access) == 12 );
 C_ASSERT( FIELD_OFFSET(struct create_debug_obj_request, flags) == 16 );
 C_ASSERT( sizeof(struct create_debug_obj_request) == 24 );
@@ -1453,6 +1471,11 @@ C_ASSERT( sizeof(struct create_named_pipe_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct set_named_pipe_info_request, handle) == 12 );
 C_ASSERT( FIELD_OFFSET(struct set_named_pipe_info_request, flags) == 16 );
 C_ASSERT( sizeof(struct set_named_pipe_info_request) == 24 );
+C_ASSERT( FIELD_OFFSET(struct get_named_pipe_shm_info_request, handle) == 12 );
+C_ASSERT( sizeof(struct get_named_pipe_shm_info_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_named_pipe_shm_info_reply, server_end) == 8 );
+C_ASSERT( FIELD_OFFSET(struct get_named_pipe_shm_info_reply, conn_id) == 12 );
+C_ASSERT( sizeof(struct get_named_pipe_shm_info_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct create_window_request, parent) == 12 );
 C_ASSERT( FIELD_OFFSET(struct create_window_request, owner) == 16 );
 C_ASSERT( FIELD_OFFSET(struct create_window_request, atom) == 20 );
@@ -949,20 +949,26 @@ static void async_poll_timeout( void *private )
     complete_async_poll( req, STATUS_TIMEOUT );
 }
 
+/* return the first queued accept request still waiting for a connection */
+static struct accept_req *get_pending_accept( struct sock *sock )
+{
+    struct accept_req *req;
+
+    LIST_FOR_EACH_ENTRY( req, &sock->accept_list, struct accept_req, entry )
+    {
+        if (req->iosb->status == STATUS_PENDING && !req->accepted) return req;
+    }
+    return NULL;
+}
+
 static int sock_dispatch_asyncs( struct sock *sock, int event, int error )
 {
     if (event & (POLLIN | POLLPRI))
     {
         struct accept_req *req;
 
-        LIST_FOR_EACH_ENTRY( req, &sock->accept_list, struct accept_req, entry )
-        {
-            if (req->iosb->status == STATUS_PENDING && !req->accepted)
-            {
-                complete_async_accept( sock, req );
-                break;
-            }
-        }
+        if ((req = get_pending_accept( sock )))
+            complete_async_accept( sock, req );
 
         if (sock->accept_recv_req && sock->accept_recv_req->iosb->status == STATUS_PENDING)
             complete_async_accept_recv( sock->accept_recv_req );
@@ -1699,6 +1705,44 @@ static int accept_new_fd( struct sock *sock )
     return acceptfd;
 }
 
+/* create a socket object for an fd accepted on a listening socket; takes ownership of the fd */
+static struct sock *create_accepted_socket( struct sock *sock, int acceptfd )
+{
+    union unix_sockaddr unix_addr;
+    struct sock *acceptsock;
+    socklen_t unix_len;
+
+    if (!(acceptsock = create_socket()))
+    {
+        close( acceptfd );
+        return NULL;
+    }
+
+    /* newly created socket gets the same properties of the listening socket */
+    acceptsock->state   = SOCK_CONNECTED;
+    acceptsock->bound   = 1;
+    acceptsock->nonblocking = sock->nonblocking;
+    acceptsock->mask    = sock->mask;
+    acceptsock->proto   = sock->proto;
+    acceptsock->type    = sock->type;
+    acceptsock->family  = sock->family;
+    acceptsock->window  = sock->window;
+    acceptsock->message = sock->message;
+    acceptsock->connect_time = current_time;
+    if (sock->event) acceptsock->event = (struct event *)grab_object( sock->event );
+    acceptsock->flags = sock->flags;
+    if (!(acceptsock->fd = create_anonymous_fd( &sock_fd_ops, acceptfd, &acceptsock->obj,
+                                                get_fd_options( sock->fd ) )))
+    {
+        release_object( acceptsock );
+        return NULL;
+    }
+    unix_len = sizeof(unix_addr);
+    if (!getsockname( acceptfd, &unix_addr.addr, &unix_len ))
+        acceptsock->addr_len = sockaddr_from_unix( &unix_addr, &acceptsock->addr.addr, sizeof(acceptsock->addr) );
+    return acceptsock;
+}
+
 /* accept a socket (creates a new fd) */
 static struct sock *accept_socket( struct sock *sock )
 {
@@ -1714,38 +1758,8 @@ static struct sock *accept_socket( struct sock *sock )
     }
     else
     {
-        union unix_sockaddr unix_addr;
-        socklen_t unix_len;
-
         if ((acceptfd = accept_new_fd( sock )) == -1) return NULL;
-        if (!(acceptsock = create_socket()))
-        {
-            close( acceptfd );
-            return NULL;
-        }
-
-        /* newly created socket gets the same properties of the listening socket */
-        acceptsock->state   = SOCK_CONNECTED;
-        acceptsock->bound   = 1;
-        acceptsock->nonblocking = sock->nonblocking;
-        acceptsock->mask    = sock->mask;
-        acceptsock->proto   = sock->proto;
-        acceptsock->type    = sock->type;
-        acceptsock->family  = sock->family;
-        acceptsock->window  = sock->window;
-        acceptsock->message = sock->message;
-        acceptsock->connect_time = current_time;
-        if (sock->event) acceptsock->event = (struct event *)grab_object( sock->event );
-        acceptsock->flags = sock->flags;
-        if (!(acceptsock->fd = create_anonymous_fd( &sock_fd_ops, acceptfd, &acceptsock->obj,
-                                                    get_fd_options( sock->fd ) )))
-        {
-            release_object( acceptsock );
-            return NULL;
-        }
-        unix_len = sizeof(unix_addr);
-        if (!getsockname( acceptfd, &unix_addr.addr, &unix_len ))
-            acceptsock->addr_len = sockaddr_from_unix( &unix_addr, &acceptsock->addr.addr, sizeof(acceptsock->addr) );
+        if (!(acceptsock = create_accepted_socket( sock, acceptfd ))) return NULL;
     }
     clear_error();
     sock->pending_events &= ~AFD_POLL_ACCEPT;
@@ -3536,3 +3550,70 @@ DECL_HANDLER(send_socket)
     }
     release_object( sock );
 }
+
+/* register a socket that the client accepted itself on a listening socket */
+DECL_HANDLER(register_accepted_socket)
+{
+    struct sock *sock, *acceptsock;
+    struct accept_req *accept_req;
+    obj_handle_t handle;
+    int fd;
+
+    if ((fd = thread_get_inflight_fd( current, req->fd )) == -1)
+    {
+        set_error( STATUS_INVALID_HANDLE );
+        return;
+    }
+    if (!(sock = (struct sock *)get_handle_obj( current->process, req->listen, FILE_READ_DATA, &sock_ops )))
+    {
+        close( fd );
+        return;
+    }
+    if (sock->state != SOCK_LISTENING)
+    {
+        close( fd );
+        release_object( sock );
+        set_error( STATUS_INVALID_PARAMETER );
+        return;
+    }
+
+    fcntl( fd, F_SETFL, O_NONBLOCK );
+    acceptsock = create_accepted_socket( sock, fd );
+
+    /* accepts queued on the server were waiting first; hand them the connection
+     * through the deferred slot, and let the client queue behind them */
+    while (acceptsock && (accept_req = get_pending_accept( sock )))
+    {
+        if (!sock->deferred)
+        {
+            sock->deferred = acceptsock;
+            acceptsock = NULL;
+        }
+        complete_async_accept( sock, accept_req );
+        /* failures are reported to the queued accept, not to us */
+        clear_error();
+    }
+
+    if (acceptsock)
+    {
+        /* a deferred connection must be returned first, keep the new one for later */
+        if (sock->deferred)
+        {
+            struct sock *deferred = sock->deferred;
+            sock->deferred = acceptsock;
+            acceptsock = deferred;
+        }
+        handle = alloc_handle( current->process, &acceptsock->obj,
+                               GENERIC_READ | GENERIC_WRITE | SYNCHRONIZE, OBJ_INHERIT );
+        acceptsock->wparam = handle;
+        sock_reselect( acceptsock );
+        release_object( acceptsock );
+        reply->handle = handle;
+    }
+
+    /* the pending connection was consumed behind our back; poll again for the next one */
+    sock->pending_events &= ~AFD_POLL_ACCEPT;
+    sock->reported_events &= ~AFD_POLL_ACCEPT;
+    sock_reselect( sock );
+    release_object( sock );
+}
@@ -1193,6 +1193,25 @@ static void dump_varargs_process_info( const char *prefix, data_size_t size )
     remove_data( size );
 }
 
+static void dump_varargs_request_stats( const char *prefix, data_size_t size )
+{
+    const struct request_stats *stats = cur_data;
+    unsigned int i, count = size / sizeof(*stats);
+
+    /* the per-process entries following the request ones are not dumped */
+    fprintf( stderr, "%s{", prefix );
+    for (i = 0; i < count && stats[i].name[0]; i++)
+    {
+        if (i) fputc( ',', stderr );
+        fprintf( stderr, "{%.*s,count=%u", (int)sizeof(stats[i].name), stats[i].name, stats[i].count );
+        dump_uint64( ",total_time=", (const unsigned __int64 *)&stats[i].total_time );
+        dump_uint64( ",max_time=", (const unsigned __int64 *)&stats[i].max_time );
+        fputc( '}', stderr );
+    }
+    fputc( '}', stderr );
+    remove_data( size );
+}
+
 static void dump_varargs_object_attributes( const char *prefix, data_size_t size )
 {
     const struct object_attributes *objattr = cur_data;
@@ -2055,6 +2074,17 @@ static void dump_send_socket_reply( const struct send_socket_reply *req )
     fprintf( stderr, ", options=%08x", req->options );
 }
 
+static void dump_register_accepted_socket_request( const struct register_accepted_socket_request *req )
+{
+    fprintf( stderr, " listen=%04x", req->listen );
+    fprintf( stderr, ", fd=%d", req->fd );
+}
+
+static void dump_register_accepted_socket_reply( const struct register_accepted_socket_reply *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
 static void dump_get_next_console_request_request( const struct get_next_console_request_request *req )
 {
     fprintf( stderr, " handle=%04x", req->handle );
@@ -2200,6 +2230,19 @@ static void dump_list_processes_reply( const struct list_processes_reply *req )
     dump_varargs_process_info( ", data=", min(cur_size,req->info_size) );
 }
 
+static void dump_get_request_stats_request( const struct get_request_stats_request *req )
+{
+    fprintf( stderr, " reset=%d", req->reset );
+}
+
+static void dump_get_request_stats_reply( const struct get_request_stats_reply *req )
+{
+    dump_timeout( " start_time=", &req->start_time );
+    fprintf( stderr, ", req_count=%d", req->req_count );
+    fprintf( stderr, ", process_count=%d", req->process_count );
+    dump_varargs_request_stats( ", stats=", cur_size );
+}
+
 static void dump_create_debug_obj_request( const struct create_debug_obj_request *req )
 {
     fprintf( stderr, " access=%08x", req->access );
@@ -2843,6 +2886,17 @@ static void dump_set_named_pipe_info_request( const struct set_named_pipe_info_r
     fprintf( stderr, ", flags=%08x", req->flags );
 }
 
+static void dump_get_named_pipe_shm_info_request( const struct get_named_pipe_shm_info_request *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
+static void dump_get_named_pipe_shm_info_reply( const struct get_named_pipe_shm_info_reply *req )
+{
+    fprintf( stderr, " server_end=%d", req->server_end );
+    fprintf( stderr, ", conn_id=%08x", req->conn_id );
+}
+
 static void dump_create_window_request( const struct create_window_request *req )
 {
     fprintf( stderr, " parent=%08x", req->parent );
@@ -4479,6 +4533,10 @@ static void dump_get_next_thread_request( const struct get_next_thread_request *
 }
 
 static void dump_get_next_thread_reply( const struct get_next_thread_reply *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
 static void dump_create_esync_request( const struct create_esync_request *req )
 {
     fprintf( stderr, " access=%08x", req->access );
@@ -4538,7 +4596,6 @@ static void dump_get_esync_apc_fd_request( const struct get_esync_apc_fd_request
 
 static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_new_process_request,
-    (dump_func)dump_exec_process_request,
     (dump_func)dump_get_new_process_info_request,
     (dump_func)dump_new_thread_request,
     (dump_func)dump_get_startup_info_request,
@@ -4594,6 +4651,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_unlock_file_request,
     (dump_func)dump_recv_socket_request,
     (dump_func)dump_send_socket_request,
+    (dump_func)dump_register_accepted_socket_request,
     (dump_func)dump_get_next_console_request_request,
     (dump_func)dump_read_directory_changes_request,
     (dump_func)dump_read_change_request,
@@ -4607,6 +4665,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_is_same_mapping_request,
     (dump_func)dump_get_mapping_filename_request,
     (dump_func)dump_list_processes_request,
+    (dump_func)dump_get_request_stats_request,
     (dump_func)dump_create_debug_obj_request,
     (dump_func)dump_wait_debug_event_request,
     (dump_func)dump_queue_exception_event_request,
@@ -4668,6 +4727,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_set_irp_result_request,
     (dump_func)dump_create_named_pipe_request,
     (dump_func)dump_set_named_pipe_info_request,
+    (dump_func)dump_get_named_pipe_shm_info_request,
     (dump_func)dump_create_window_request,
     (dump_func)dump_destroy_window_request,
     (dump_func)dump_get_desktop_window_request,
@@ -4878,6 +4938,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     NULL,
     (dump_func)dump_recv_socket_reply,
     (dump_func)dump_send_socket_reply,
+    (dump_func)dump_register_accepted_socket_reply,
     (dump_func)dump_get_next_console_request_reply,
     NULL,
     (dump_func)dump_read_change_reply,
@@ -4891,6 +4952,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     NULL,
     (dump_func)dump_get_mapping_filename_reply,
     (dump_func)dump_list_processes_reply,
+    (dump_func)dump_get_request_stats_reply,
     (dump_func)dump_create_debug_obj_reply,
     (dump_func)dump_wait_debug_event_reply,
     (dump_func)dump_queue_exception_event_reply,
@@ -4952,6 +5014,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     NULL,
     (dump_func)dump_create_named_pipe_reply,
     NULL,
+    (dump_func)dump_get_named_pipe_shm_info_reply,
     (dump_func)dump_create_window_reply,
     NULL,
     (dump_func)dump_get_desktop_window_reply,
@@ -5097,6 +5160,12 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     NULL,
     NULL,
     (dump_func)dump_get_next_thread_reply,
+    (dump_func)dump_create_esync_reply,
+    (dump_func)dump_open_esync_reply,
+    (dump_func)dump_get_esync_read_fd_reply,
+    NULL,
+    NULL,
+    NULL,
 };
 
 static const char * const req_names[REQ_NB_REQUESTS] = {
@@ -5156,6 +5225,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "unlock_file",
     "recv_socket",
     "send_socket",
+    "register_accepted_socket",
     "get_next_console_request",
     "read_directory_changes",
     "read_change",
@@ -5169,6 +5239,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "is_same_mapping",
     "get_mapping_filename",
     "list_processes",
+    "get_request_stats",
     "create_debug_obj",
     "wait_debug_event",
     "queue_exception_event",
@@ -5230,6 +5301,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "set_irp_result",
     "create_named_pipe",
     "set_named_pipe_info",
+    "get_named_pipe_shm_info",
     "create_window",
     "destroy_window",
     "get_desktop_window",
@@ -5420,6 +5492,7 @@ static const struct
     { "ERROR_HOTKEY_NOT_REGISTERED", 0xc0010000 | ERROR_HOTKEY_NOT_REGISTERED },
     { "ERROR_INVALID_CURSOR_HANDLE", 0xc0010000 | ERROR_INVALID_CURSOR_HANDLE },
     { "ERROR_INVALID_INDEX",         0xc0010000 | ERROR_INVALID_INDEX },
+    { "ERROR_INVALID_MONITOR_HANDLE", 0xc0010000 | ERROR_INVALID_MONITOR_HANDLE },
     { "ERROR_INVALID_WINDOW_HANDLE", 0xc0010000 | ERROR_INVALID_WINDOW_HANDLE },
     { "ERROR_NO_MORE_USER_HANDLES",  0xc0010000 | ERROR_NO_MORE_USER_HANDLES },
     { "ERROR_WINDOW_OF_OTHER_THREAD", 0xc0010000 | ERROR_WINDOW_OF_OTHER_THREAD },
@@ -5615,3 +5688,8 @@ void trace_reply( enum request req, const union generic_reply *reply )
     else fprintf( stderr, "%04x: %d() = %s\n",
                   current->id, req, get_status_name(current->error) );
 }
+
+const char *get_request_name( enum request req )
+{
+    return req < REQ_NB_REQUESTS ? req_names[req] : NULL;
+}